@@ -98,6 +98,7 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtLegendData \
         QwtLegendLabel \
         QwtPointMapper \
+        QwtPointIndex \
         QwtMatrixRasterData \
         QwtOHLCSample \
         QwtPlot \
@@ -140,12 +141,16 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtSamplingThread \
         QwtSplineCurveFitter \
         QwtWeedingCurveFitter \
+        QwtWeedingBuffer \
         QwtIntervalSeriesData \
         QwtPoint3DSeriesData \
         QwtPointSeriesData \
         QwtSetSeriesData \
         QwtSyntheticPointData \
         QwtPointArrayData \
+        QwtPyramidPointData \
+        QwtRingBufferSeriesData \
+        QwtStreamingHistogramData \
         QwtTradingChartData \
         QwtVectorFieldSymbol \
         QwtVectorFieldArrow \
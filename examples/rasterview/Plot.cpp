@@ -114,6 +114,9 @@ void Plot::exportPlot()
 
 void Plot::setResampleMode( int mode )
 {
+    // the data must not be in use while being modified
+    m_spectrogram->invalidateCache();
+
     RasterData* rasterData = static_cast< RasterData* >( m_spectrogram->data() );
     rasterData->setResampleMode(
         static_cast< QwtMatrixRasterData::ResampleMode >( mode ) );
@@ -12,6 +12,8 @@
 
 #include <qvector.h>
 
+#include <algorithm>
+
 static inline QRgb qwtHsvToRgb( int h, int s, int v, int a )
 {
 #if 0
@@ -266,6 +268,26 @@ void QwtColorMap::setFormat( Format format )
     m_format = format;
 }
 
+/*!
+   \brief Map values of a given interval into RGB values
+
+   The default implementation calls rgb() for each value.
+
+   \param interval Range for all values
+   \param values Array of values
+   \param numValues Number of values
+   \param rgbs Array for the numValues RGB values
+
+   \note Values are mapped like in rgb() - including NaN values
+   \sa rgb()
+ */
+void QwtColorMap::rgbValues( const QwtInterval& interval,
+    const double* values, int numValues, QRgb* rgbs ) const
+{
+    for ( int i = 0; i < numValues; i++ )
+        rgbs[i] = rgb( interval, values[i] );
+}
+
 /*!
    \brief Map a value of a given interval into a color index
 
@@ -335,11 +357,25 @@ QVector< QRgb > QwtColorMap::colorTable( int numColors ) const
     return table;
 }
 
+// number of colors of the table for QwtLinearColorMap::rgbValues()
+static const int qwtLookupTableSize = 4096;
+
 class QwtLinearColorMap::PrivateData
 {
   public:
+    void updateLookupTable()
+    {
+        lookupTable.resize( qwtLookupTableSize );
+
+        const double step = 1.0 / ( qwtLookupTableSize - 1 );
+        for ( int i = 0; i < qwtLookupTableSize; i++ )
+            lookupTable[i] = colorStops.rgb( mode, i * step );
+    }
+
     ColorStops colorStops;
     QwtLinearColorMap::Mode mode;
+
+    QVector< QRgb > lookupTable;
 };
 
 /*!
@@ -390,7 +426,11 @@ QwtLinearColorMap::~QwtLinearColorMap()
  */
 void QwtLinearColorMap::setMode( Mode mode )
 {
-    m_data->mode = mode;
+    if ( mode != m_data->mode )
+    {
+        m_data->mode = mode;
+        m_data->updateLookupTable();
+    }
 }
 
 /*!
@@ -418,6 +458,8 @@ void QwtLinearColorMap::setColorInterval(
     m_data->colorStops = ColorStops();
     m_data->colorStops.insert( 0.0, color1 );
     m_data->colorStops.insert( 1.0, color2 );
+
+    m_data->updateLookupTable();
 }
 
 /*!
@@ -433,7 +475,10 @@ void QwtLinearColorMap::setColorInterval(
 void QwtLinearColorMap::addColorStop( double value, const QColor& color )
 {
     if ( value >= 0.0 && value <= 1.0 )
+    {
         m_data->colorStops.insert( value, color );
+        m_data->updateLookupTable();
+    }
 }
 
 /*!
@@ -481,6 +526,62 @@ QRgb QwtLinearColorMap::rgb(
     return m_data->colorStops.rgb( m_data->mode, ratio );
 }
 
+/*!
+   \brief Map values of a given interval into RGB values
+
+   In ScaledColors mode the colors are taken from a precalculated
+   table of 4096 colors instead of interpolating the color stops
+   for each value. In FixedColors mode the borders between the colors
+   have to be exact and the colors are calculated like in rgb().
+
+   \param interval Range for all values
+   \param values Array of values
+   \param numValues Number of values
+   \param rgbs Array for the numValues RGB values
+
+   \note Values are mapped like in rgb() - including NaN values
+   \sa rgb()
+ */
+void QwtLinearColorMap::rgbValues( const QwtInterval& interval,
+    const double* values, int numValues, QRgb* rgbs ) const
+{
+    if ( m_data->mode == FixedColors )
+    {
+        QwtColorMap::rgbValues( interval, values, numValues, rgbs );
+        return;
+    }
+
+    const double width = interval.width();
+    if ( width <= 0.0 )
+    {
+        std::fill( rgbs, rgbs + numValues, 0u );
+        return;
+    }
+
+    const QRgb* table = m_data->lookupTable.constData();
+
+    const double maxIndex = m_data->lookupTable.size() - 1;
+    const double min = interval.minValue();
+    const double factor = maxIndex / width;
+
+    for ( int i = 0; i < numValues; i++ )
+    {
+        // rounding to the closest entry
+        const double v = ( values[i] - min ) * factor + 0.5;
+
+        if ( v == v )
+        {
+            const int index = static_cast< int >( qBound( 0.0, v, maxIndex ) );
+            rgbs[i] = table[index];
+        }
+        else
+        {
+            // NaN: qBound would return maxIndex
+            rgbs[i] = rgb( interval, values[i] );
+        }
+    }
+}
+
 /*!
    \brief Map a value of a given interval into a color index
 
@@ -75,6 +75,9 @@ class QWT_EXPORT QwtColorMap
      */
     virtual QRgb rgb( const QwtInterval& interval, double value ) const = 0;
 
+    virtual void rgbValues( const QwtInterval&,
+        const double* values, int numValues, QRgb* rgbs ) const;
+
     virtual uint colorIndex( int numColors,
         const QwtInterval& interval, double value ) const;
 
@@ -94,6 +97,9 @@ class QWT_EXPORT QwtColorMap
    A color stop is a color at a specific position. The valid
    range for the positions is [0.0, 1.0]. When mapping a value
    into a color it is translated into this interval according to mode().
+
+   In ScaledColors mode rgbValues() maps arrays of values using a table
+   of 4096 colors, that is updated, whenever the color stops are changed.
  */
 class QWT_EXPORT QwtLinearColorMap : public QwtColorMap
 {
@@ -131,6 +137,9 @@ class QWT_EXPORT QwtLinearColorMap : public QwtColorMap
     virtual QRgb rgb( const QwtInterval&,
         double value ) const QWT_OVERRIDE;
 
+    virtual void rgbValues( const QwtInterval&, const double* values,
+        int numValues, QRgb* rgbs ) const QWT_OVERRIDE;
+
     virtual uint colorIndex( int numColors,
         const QwtInterval&, double value ) const QWT_OVERRIDE;
 
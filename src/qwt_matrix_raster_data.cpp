@@ -13,6 +13,13 @@
 #include <qvector.h>
 #include <qnumeric.h>
 #include <qrect.h>
+#include <qfile.h>
+#include <qmutex.h>
+#include <qsharedpointer.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
 
 static inline double qwtHermiteInterpolate(
     double A, double B, double C, double D, double t )
@@ -43,24 +50,673 @@ static inline double qwtBicubicInterpolate(
     return qwtHermiteInterpolate( v0, v1, v2, v3, dy );
 }
 
+static inline bool qwtIsValidScale( double scale, double offset )
+{
+    // scale is a divisor in QwtMatrixRasterData::setValue()
+    return qIsFinite( scale ) && ( scale != 0.0 ) && qIsFinite( offset );
+}
+
+namespace
+{
+    /*
+        The indexes of the matrix and the interpolation parameter, that
+        are needed for a x or y position. As long as the resample mode
+        and the matrix do not change, they are the same for
+        all rows or columns of a grid.
+     */
+    class GridSample
+    {
+      public:
+        bool isValid;
+        int index[4];
+        double t;
+    };
+
+    // header of a matrix file, see QwtMatrixRasterData::setValueMatrixFile()
+    class FileHeader
+    {
+      public:
+        char magic[8];
+        quint32 byteOrder;
+        quint32 valueType;
+        quint32 numColumns;
+        quint32 numRows;
+        double scale;
+        double offset;
+    };
+}
+
+namespace
+{
+    // the value matrix or one of its downsampled levels
+    class MatrixView
+    {
+      public:
+        inline double value( int row, int col ) const
+        {
+            const int index = row * numColumns + col;
+
+            switch( type )
+            {
+                case QwtMatrixRasterData::Float:
+                    return static_cast< const float* >( values )[ index ];
+
+                case QwtMatrixRasterData::Int16:
+                    return offset + scale * static_cast< const qint16* >( values )[ index ];
+
+                case QwtMatrixRasterData::UInt8:
+                    return offset + scale * static_cast< const quint8* >( values )[ index ];
+
+                default:
+                    return static_cast< const double* >( values )[ index ];
+            }
+        }
+
+        QwtMatrixRasterData::ValueType type;
+        const void* values;
+
+        double scale;
+        double offset;
+
+        int numColumns;
+        int numRows;
+
+        double dx;
+        double dy;
+    };
+
+    class PyramidLevel
+    {
+      public:
+        int level; // 1, 2, ...
+        QVector< float > values;
+
+        int numColumns;
+        int numRows;
+    };
+}
+
+static const char qwtFileMagic[8] = { 'Q', 'W', 'T', 'M', 'A', 'T', 'R', 'X' };
+static const quint32 qwtFileByteOrder = 0x01020304;
+
+static inline int qwtValueSize( QwtMatrixRasterData::ValueType type )
+{
+    switch( type )
+    {
+        case QwtMatrixRasterData::Float:
+            return sizeof( float );
+
+        case QwtMatrixRasterData::Int16:
+            return sizeof( qint16 );
+
+        case QwtMatrixRasterData::UInt8:
+            return sizeof( quint8 );
+
+        default:
+            return sizeof( double );
+    }
+}
+
+static void qwtGridSamples( QwtMatrixRasterData::ResampleMode mode,
+    const QwtInterval& interval, double step, int count,
+    const double* positions, int numPositions, GridSample* samples )
+{
+    const double min = interval.minValue();
+
+    for ( int i = 0; i < numPositions; i++ )
+    {
+        const double pos = positions[i];
+        GridSample& sample = samples[i];
+
+        sample.isValid = interval.contains( pos );
+        if ( !sample.isValid )
+            continue;
+
+        switch( mode )
+        {
+            case QwtMatrixRasterData::BicubicInterpolation:
+            {
+                const double f = ( pos - min ) / step;
+                const int index = qRound( f );
+
+                int i0 = index - 2;
+                int i1 = index - 1;
+                int i2 = index;
+                int i3 = index + 1;
+
+                if ( i1 < 0 )
+                    i1 = i2;
+
+                if ( i0 < 0 )
+                    i0 = i1;
+
+                if ( i2 >= count )
+                    i2 = i1;
+
+                if ( i3 >= count )
+                    i3 = i2;
+
+                sample.index[0] = i0;
+                sample.index[1] = i1;
+                sample.index[2] = i2;
+                sample.index[3] = i3;
+                sample.t = f - index + 0.5;
+
+                break;
+            }
+            case QwtMatrixRasterData::BilinearInterpolation:
+            {
+                int i1 = qRound( ( pos - min ) / step ) - 1;
+                int i2 = i1 + 1;
+
+                if ( i1 < 0 )
+                    i1 = i2;
+                else if ( i2 >= count )
+                    i2 = i1;
+
+                const double pos2 = min + ( i2 + 0.5 ) * step;
+
+                sample.index[0] = i1;
+                sample.index[1] = i2;
+                sample.t = ( pos2 - pos ) / step;
+
+                break;
+            }
+            case QwtMatrixRasterData::NearestNeighbour:
+            default:
+            {
+                int index = int( ( pos - min ) / step );
+                if ( index >= count )
+                    index = count - 1;
+
+                sample.index[0] = index;
+            }
+        }
+    }
+}
+
+static inline double qwtAggregate(
+    QwtMatrixRasterData::PyramidMode mode, const double* values )
+{
+    double sum = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    int count = 0;
+
+    for ( int i = 0; i < 4; i++ )
+    {
+        const double v = values[i];
+        if ( qIsNaN( v ) )
+            continue;
+
+        if ( count == 0 )
+        {
+            min = max = v;
+        }
+        else
+        {
+            min = qMin( min, v );
+            max = qMax( max, v );
+        }
+
+        sum += v;
+        count++;
+    }
+
+    if ( count == 0 )
+        return qQNaN();
+
+    switch( mode )
+    {
+        case QwtMatrixRasterData::MinimumPyramid:
+            return min;
+
+        case QwtMatrixRasterData::MaximumPyramid:
+            return max;
+
+        default:
+            return sum / count;
+    }
+}
+
+template< typename T >
+static void qwtDownsample( QwtMatrixRasterData::PyramidMode mode,
+    const T* values, int numColumns, int numRows,
+    double scale, double offset, float* levelValues )
+{
+    const int levelColumns = ( numColumns + 1 ) / 2;
+    const int levelRows = ( numRows + 1 ) / 2;
+
+    for ( int row = 0; row < levelRows; row++ )
+    {
+        // for an odd number of rows/columns the last one is used twice
+
+        const T* l1 = values + 2 * row * numColumns;
+        const T* l2 = ( 2 * row + 1 < numRows ) ? l1 + numColumns : l1;
+
+        float* line = levelValues + row * levelColumns;
+
+        for ( int col = 0; col < levelColumns; col++ )
+        {
+            const int c1 = 2 * col;
+            const int c2 = ( c1 + 1 < numColumns ) ? c1 + 1 : c1;
+
+            const double v[4] = { double( l1[c1] ), double( l1[c2] ),
+                double( l2[c1] ), double( l2[c2] ) };
+
+            line[col] = static_cast< float >( offset + scale * qwtAggregate( mode, v ) );
+        }
+    }
+}
+
+template< typename T >
+static void qwtResampleGrid( QwtMatrixRasterData::ResampleMode mode,
+    const T* matrix, int stride, const GridSample* xs, int numColumns,
+    const GridSample* ys, int numRows, double* values )
+{
+    for ( int row = 0; row < numRows; row++ )
+    {
+        const GridSample& y = ys[row];
+        double* line = values + row * numColumns;
+
+        if ( !y.isValid )
+        {
+            std::fill( line, line + numColumns, qQNaN() );
+            continue;
+        }
+
+        switch( mode )
+        {
+            case QwtMatrixRasterData::BicubicInterpolation:
+            {
+                const T* l0 = matrix + y.index[0] * stride;
+                const T* l1 = matrix + y.index[1] * stride;
+                const T* l2 = matrix + y.index[2] * stride;
+                const T* l3 = matrix + y.index[3] * stride;
+
+                for ( int col = 0; col < numColumns; col++ )
+                {
+                    const GridSample& s = xs[col];
+                    if ( !s.isValid )
+                    {
+                        line[col] = qQNaN();
+                        continue;
+                    }
+
+                    const int c0 = s.index[0];
+                    const int c1 = s.index[1];
+                    const int c2 = s.index[2];
+                    const int c3 = s.index[3];
+
+                    line[col] = qwtBicubicInterpolate(
+                        l0[c0], l0[c1], l0[c2], l0[c3],
+                        l1[c0], l1[c1], l1[c2], l1[c3],
+                        l2[c0], l2[c1], l2[c2], l2[c3],
+                        l3[c0], l3[c1], l3[c2], l3[c3],
+                        s.t, y.t );
+                }
+                break;
+            }
+            case QwtMatrixRasterData::BilinearInterpolation:
+            {
+                const T* l1 = matrix + y.index[0] * stride;
+                const T* l2 = matrix + y.index[1] * stride;
+
+                const double ry = y.t;
+
+                for ( int col = 0; col < numColumns; col++ )
+                {
+                    const GridSample& s = xs[col];
+                    if ( !s.isValid )
+                    {
+                        line[col] = qQNaN();
+                        continue;
+                    }
+
+                    const double rx = s.t;
+
+                    const double vr1 = rx * l1[ s.index[0] ] + ( 1.0 - rx ) * l1[ s.index[1] ];
+                    const double vr2 = rx * l2[ s.index[0] ] + ( 1.0 - rx ) * l2[ s.index[1] ];
+
+                    line[col] = ry * vr1 + ( 1.0 - ry ) * vr2;
+                }
+                break;
+            }
+            case QwtMatrixRasterData::NearestNeighbour:
+            default:
+            {
+                const T* l = matrix + y.index[0] * stride;
+
+                for ( int col = 0; col < numColumns; col++ )
+                {
+                    const GridSample& s = xs[col];
+                    line[col] = s.isValid ? double( l[ s.index[0] ] ) : qQNaN();
+                }
+            }
+        }
+    }
+}
+
+static double qwtValue( QwtMatrixRasterData::ResampleMode mode,
+    const MatrixView& m, const QwtInterval& xInterval,
+    const QwtInterval& yInterval, double x, double y )
+{
+    if ( !( xInterval.contains(x) && yInterval.contains(y) ) )
+        return qQNaN();
+
+    double value;
+
+    switch( mode )
+    {
+        case QwtMatrixRasterData::BicubicInterpolation:
+        {
+            const double colF = ( x - xInterval.minValue() ) / m.dx;
+            const double rowF = ( y - yInterval.minValue() ) / m.dy;
+
+            const int col = qRound( colF );
+            const int row = qRound( rowF );
+
+            int col0 = col - 2;
+            int col1 = col - 1;
+            int col2 = col;
+            int col3 = col + 1;
+
+            if ( col1 < 0 )
+                col1 = col2;
+
+            if ( col0 < 0 )
+                col0 = col1;
+
+            if ( col2 >= m.numColumns )
+                col2 = col1;
+
+            if ( col3 >= m.numColumns )
+                col3 = col2;
+
+            int row0 = row - 2;
+            int row1 = row - 1;
+            int row2 = row;
+            int row3 = row + 1;
+
+            if ( row1 < 0 )
+                row1 = row2;
+
+            if ( row0 < 0 )
+                row0 = row1;
+
+            if ( row2 >= m.numRows )
+                row2 = row1;
+
+            if ( row3 >= m.numRows )
+                row3 = row2;
+
+            // First row
+            const double v00 = m.value( row0, col0 );
+            const double v10 = m.value( row0, col1 );
+            const double v20 = m.value( row0, col2 );
+            const double v30 = m.value( row0, col3 );
+
+            // Second row
+            const double v01 = m.value( row1, col0 );
+            const double v11 = m.value( row1, col1 );
+            const double v21 = m.value( row1, col2 );
+            const double v31 = m.value( row1, col3 );
+
+            // Third row
+            const double v02 = m.value( row2, col0 );
+            const double v12 = m.value( row2, col1 );
+            const double v22 = m.value( row2, col2 );
+            const double v32 = m.value( row2, col3 );
+
+            // Fourth row
+            const double v03 = m.value( row3, col0 );
+            const double v13 = m.value( row3, col1 );
+            const double v23 = m.value( row3, col2 );
+            const double v33 = m.value( row3, col3 );
+
+            value = qwtBicubicInterpolate(
+                v00, v10, v20, v30, v01, v11, v21, v31,
+                v02, v12, v22, v32, v03, v13, v23, v33,
+                colF - col + 0.5, rowF - row + 0.5 );
+
+            break;
+        }
+        case QwtMatrixRasterData::BilinearInterpolation:
+        {
+            int col1 = qRound( ( x - xInterval.minValue() ) / m.dx ) - 1;
+            int row1 = qRound( ( y - yInterval.minValue() ) / m.dy ) - 1;
+            int col2 = col1 + 1;
+            int row2 = row1 + 1;
+
+            if ( col1 < 0 )
+                col1 = col2;
+            else if ( col2 >= m.numColumns )
+                col2 = col1;
+
+            if ( row1 < 0 )
+                row1 = row2;
+            else if ( row2 >= m.numRows )
+                row2 = row1;
+
+            const double v11 = m.value( row1, col1 );
+            const double v21 = m.value( row1, col2 );
+            const double v12 = m.value( row2, col1 );
+            const double v22 = m.value( row2, col2 );
+
+            const double x2 = xInterval.minValue() + ( col2 + 0.5 ) * m.dx;
+            const double y2 = yInterval.minValue() + ( row2 + 0.5 ) * m.dy;
+
+            const double rx = ( x2 - x ) / m.dx;
+            const double ry = ( y2 - y ) / m.dy;
+
+            const double vr1 = rx * v11 + ( 1.0 - rx ) * v21;
+            const double vr2 = rx * v12 + ( 1.0 - rx ) * v22;
+
+            value = ry * vr1 + ( 1.0 - ry ) * vr2;
+
+            break;
+        }
+        case QwtMatrixRasterData::NearestNeighbour:
+        default:
+        {
+            int row = int( ( y - yInterval.minValue() ) / m.dy );
+            int col = int( ( x - xInterval.minValue() ) / m.dx );
+
+            // In case of intervals, where the maximum is included
+            // we get out of bound for row/col, when the value for the
+            // maximum is requested. Instead we return the value
+            // from the last row/col
+
+            if ( row >= m.numRows )
+                row = m.numRows - 1;
+
+            if ( col >= m.numColumns )
+                col = m.numColumns - 1;
+
+            value = m.value( row, col );
+        }
+    }
+
+    return value;
+}
+
+static int qwtPyramidLevel( const double* xValues, int numColumns, double dx,
+    const double* yValues, int numRows, double dy )
+{
+    if ( dx <= 0.0 || dy <= 0.0 )
+        return 0;
+
+    // number of values of the matrix between neighboured positions
+
+    double ratio = 0.0;
+
+    if ( numColumns > 1 )
+    {
+        const double d = xValues[numColumns - 1] - xValues[0];
+        ratio = qAbs( d / ( numColumns - 1 ) ) / dx;
+    }
+
+    if ( numRows > 1 )
+    {
+        const double d = yValues[numRows - 1] - yValues[0];
+        const double ratioY = qAbs( d / ( numRows - 1 ) ) / dy;
+
+        ratio = ( numColumns > 1 ) ? qMin( ratio, ratioY ) : ratioY;
+    }
+
+    int level = 0;
+    while ( ratio >= 2.0 && level < 30 )
+    {
+        ratio *= 0.5;
+        level++;
+    }
+
+    return level;
+}
+
 class QwtMatrixRasterData::PrivateData
 {
   public:
     PrivateData()
         : resampleMode( QwtMatrixRasterData::NearestNeighbour )
+        , pyramidMode( QwtMatrixRasterData::NoPyramid )
+        , valueType( QwtMatrixRasterData::Double )
+        , scale( 1.0 )
+        , offset( 0.0 )
+        , matrix( NULL )
+        , numValues( 0 )
+        , file( NULL )
         , numColumns(0)
     {
     }
 
-    inline double value(int row, int col) const
+    ~PrivateData()
+    {
+        // also unmaps the file
+        delete file;
+    }
+
+    MatrixView view() const
+    {
+        MatrixView m;
+        m.type = valueType;
+        m.values = matrix;
+        m.scale = scale;
+        m.offset = offset;
+        m.numColumns = numColumns;
+        m.numRows = numRows;
+        m.dx = dx;
+        m.dy = dy;
+
+        return m;
+    }
+
+    MatrixView view( const PyramidLevel& l ) const
+    {
+        MatrixView m;
+        m.type = QwtMatrixRasterData::Float;
+        m.values = l.values.constData();
+        m.scale = 1.0;
+        m.offset = 0.0;
+        m.numColumns = l.numColumns;
+        m.numRows = l.numRows;
+        m.dx = dx * ( 1 << l.level );
+        m.dy = dy * ( 1 << l.level );
+
+        return m;
+    }
+
+    /*
+        The level is shared with the caller, so that it stays alive
+        while being resampled - even when the levels are cleared meanwhile.
+     */
+    QSharedPointer< const PyramidLevel > pyramidLevel( int level )
+    {
+        // creating the missing levels up to level
+
+        const QMutexLocker locker( &levelMutex );
+
+        while ( levels.size() < level )
+        {
+            const MatrixView m = levels.isEmpty() ? view() : view( *levels.last() );
+            if ( m.numColumns <= 1 && m.numRows <= 1 )
+                break;
+
+            PyramidLevel* l = new PyramidLevel();
+            l->level = levels.size() + 1;
+            l->numColumns = ( m.numColumns + 1 ) / 2;
+            l->numRows = ( m.numRows + 1 ) / 2;
+            l->values.resize( l->numColumns * l->numRows );
+
+            const QwtMatrixRasterData::PyramidMode mode = pyramidMode;
+            float* values = l->values.data();
+
+            switch( m.type )
+            {
+                case QwtMatrixRasterData::Float:
+                {
+                    qwtDownsample( mode, static_cast< const float* >( m.values ),
+                        m.numColumns, m.numRows, m.scale, m.offset, values );
+                    break;
+                }
+                case QwtMatrixRasterData::Int16:
+                {
+                    qwtDownsample( mode, static_cast< const qint16* >( m.values ),
+                        m.numColumns, m.numRows, m.scale, m.offset, values );
+                    break;
+                }
+                case QwtMatrixRasterData::UInt8:
+                {
+                    qwtDownsample( mode, static_cast< const quint8* >( m.values ),
+                        m.numColumns, m.numRows, m.scale, m.offset, values );
+                    break;
+                }
+                default:
+                {
+                    qwtDownsample( mode, static_cast< const double* >( m.values ),
+                        m.numColumns, m.numRows, m.scale, m.offset, values );
+                }
+            }
+
+            levels += QSharedPointer< const PyramidLevel >( l );
+        }
+
+        if ( levels.isEmpty() )
+            return QSharedPointer< const PyramidLevel >();
+
+        return levels[ qMin( level, levels.size() ) - 1 ];
+    }
+
+    void clearLevels()
     {
-        return values.data()[ row * numColumns + col ];
+        const QMutexLocker locker( &levelMutex );
+        levels.clear();
     }
 
     QwtInterval intervals[3];
     QwtMatrixRasterData::ResampleMode resampleMode;
 
+    QwtMatrixRasterData::PyramidMode pyramidMode;
+    // levels are created by concurrent calls of values()
+    QVector< QSharedPointer< const PyramidLevel > > levels;
+    QMutex levelMutex;
+
+    QwtMatrixRasterData::ValueType valueType;
+    double scale;
+    double offset;
+
+    // only one of them is in use
     QVector< double > values;
+    QVector< float > floatValues;
+    QVector< qint16 > int16Values;
+    QVector< quint8 > uint8Values;
+
+    // the first value of the vector in use, or of the mapped file
+    const void* matrix;
+    int numValues;
+
+    QFile* file;
+
     int numColumns;
     int numRows;
 
@@ -101,6 +757,40 @@ QwtMatrixRasterData::ResampleMode QwtMatrixRasterData::resampleMode() const
     return m_data->resampleMode;
 }
 
+/*!
+   \brief Set the aggregation of the downsampled levels
+
+   When a pyramid mode is set, values() selects a downsampled level
+   of the value matrix, that fits to the distance between
+   the requested positions. The levels are created on demand
+   and kept until the value matrix or the pyramid mode is changed.
+   value() and pointValues() always resample the value matrix.
+
+   A pyramid needs about a third of the values of the matrix
+   stored as floats, what also applies to memory mapped matrices.
+
+   \param mode Pyramid mode
+   \sa pyramidMode(), values()
+ */
+void QwtMatrixRasterData::setPyramidMode( PyramidMode mode )
+{
+    if ( mode != m_data->pyramidMode )
+    {
+        m_data->pyramidMode = mode;
+
+        m_data->clearLevels();
+    }
+}
+
+/*!
+   \return Aggregation of the downsampled levels
+   \sa setPyramidMode()
+ */
+QwtMatrixRasterData::PyramidMode QwtMatrixRasterData::pyramidMode() const
+{
+    return m_data->pyramidMode;
+}
+
 /*!
    \brief Assign the bounding interval for an axis
 
@@ -155,36 +845,318 @@ QwtInterval QwtMatrixRasterData::interval( Qt::Axis axis ) const
 void QwtMatrixRasterData::setValueMatrix(
     const QVector< double >& values, int numColumns )
 {
+    resetValues();
+
     m_data->values = values;
+    m_data->matrix = m_data->values.constData();
+    m_data->numValues = values.size();
     m_data->numColumns = qMax( numColumns, 0 );
+
     update();
 }
 
+/*!
+   \brief Assign a matrix of float values
+
+   A matrix of floats needs half of the memory of a matrix of doubles.
+
+   \param values Vector of values
+   \param numColumns Number of columns
+
+   \sa setValueMatrix( const QVector< double >&, int ), valueType()
+ */
+void QwtMatrixRasterData::setValueMatrix(
+    const QVector< float >& values, int numColumns )
+{
+    resetValues();
+
+    m_data->valueType = Float;
+    m_data->floatValues = values;
+    m_data->matrix = m_data->floatValues.constData();
+    m_data->numValues = values.size();
+    m_data->numColumns = qMax( numColumns, 0 );
+
+    update();
+}
+
+/*!
+   \brief Assign a matrix of 16 bit integers
+
+   The values of the matrix are: offset + scale * values[i]
+
+   \param values Vector of values
+   \param numColumns Number of columns
+   \param scale Factor for the integers
+   \param offset Offset for the integers
+
+   \note When scale is 0 or scale/offset are not finite the matrix is empty
+   \sa setValueMatrix( const QVector< double >&, int ), valueType()
+ */
+void QwtMatrixRasterData::setValueMatrix( const QVector< qint16 >& values,
+    int numColumns, double scale, double offset )
+{
+    resetValues();
+
+    if ( !qwtIsValidScale( scale, offset ) )
+    {
+        update();
+        return;
+    }
+
+    m_data->valueType = Int16;
+    m_data->scale = scale;
+    m_data->offset = offset;
+    m_data->int16Values = values;
+    m_data->matrix = m_data->int16Values.constData();
+    m_data->numValues = values.size();
+    m_data->numColumns = qMax( numColumns, 0 );
+
+    update();
+}
+
+/*!
+   \brief Assign a matrix of 8 bit integers
+
+   The values of the matrix are: offset + scale * values[i]
+
+   \param values Vector of values
+   \param numColumns Number of columns
+   \param scale Factor for the integers
+   \param offset Offset for the integers
+
+   \note When scale is 0 or scale/offset are not finite the matrix is empty
+   \sa setValueMatrix( const QVector< double >&, int ), valueType()
+ */
+void QwtMatrixRasterData::setValueMatrix( const QVector< quint8 >& values,
+    int numColumns, double scale, double offset )
+{
+    resetValues();
+
+    if ( !qwtIsValidScale( scale, offset ) )
+    {
+        update();
+        return;
+    }
+
+    m_data->valueType = UInt8;
+    m_data->scale = scale;
+    m_data->offset = offset;
+    m_data->uint8Values = values;
+    m_data->matrix = m_data->uint8Values.constData();
+    m_data->numValues = values.size();
+    m_data->numColumns = qMax( numColumns, 0 );
+
+    update();
+}
+
+/*!
+   \brief Map a value matrix from a file
+
+   The file is mapped into memory read-only and the values are
+   read from the mapping, when resampling. So opening even huge
+   files is fast and the memory, that is needed for the values,
+   is managed by the operating system.
+
+   The file starts with a header of 40 bytes, followed
+   by the values of the matrix row by row:
+
+   - 8 bytes: "QWTMATRX"
+   - quint32: 0x01020304 to identify the byte order.
+     The byte order of the file has to be the one of the host.
+   - quint32: ValueType
+   - quint32: Number of columns
+   - quint32: Number of rows
+   - double: Scale for integer values
+   - double: Offset for integer values
+
+   \param fileName Name of the file
+   \return true, when the file could be mapped. Otherwise the
+           matrix is empty. Integer matrices with a scale of 0
+           or a non finite scale/offset are rejected.
+
+   \note The file must not be modified, while it is mapped.
+   \sa setValueMatrix(), valueType()
+ */
+bool QwtMatrixRasterData::setValueMatrixFile( const QString& fileName )
+{
+    resetValues();
+
+    QFile* file = new QFile( fileName );
+
+    const uchar* data = NULL;
+    FileHeader header;
+
+    if ( file->open( QIODevice::ReadOnly ) )
+    {
+        const qint64 fileSize = file->size();
+        if ( fileSize >= qint64( sizeof( header ) ) )
+            data = file->map( 0, fileSize );
+
+        if ( data )
+        {
+            std::memcpy( &header, data, sizeof( header ) );
+
+            bool ok = ( std::memcmp( header.magic, qwtFileMagic, sizeof( qwtFileMagic ) ) == 0 )
+                && ( header.byteOrder == qwtFileByteOrder )
+                && ( header.valueType <= UInt8 )
+                && ( header.numColumns > 0 ) && ( header.numRows > 0 );
+
+            if ( ok && header.valueType != Double && header.valueType != Float )
+                ok = qwtIsValidScale( header.scale, header.offset );
+
+            if ( ok )
+            {
+                const qint64 numValues = qint64( header.numColumns ) * header.numRows;
+                const int valueSize = qwtValueSize( static_cast< ValueType >( header.valueType ) );
+
+                ok = ( numValues <= INT_MAX )
+                    && ( qint64( sizeof( header ) ) + numValues * valueSize <= fileSize );
+            }
+
+            if ( !ok )
+                data = NULL;
+        }
+    }
+
+    if ( data == NULL )
+    {
+        delete file;
+        update();
+
+        return false;
+    }
+
+    m_data->file = file;
+
+    m_data->valueType = static_cast< ValueType >( header.valueType );
+    if ( m_data->valueType == Int16 || m_data->valueType == UInt8 )
+    {
+        m_data->scale = header.scale;
+        m_data->offset = header.offset;
+    }
+
+    m_data->matrix = data + sizeof( header );
+    m_data->numValues = header.numColumns * header.numRows;
+    m_data->numColumns = header.numColumns;
+
+    update();
+
+    return true;
+}
+
 /*!
    \return Value matrix
+   \note For other value types than Double the values are converted
+         into a new vector
+
    \sa setValueMatrix(), numColumns(), numRows(), setInterval()
  */
 const QVector< double > QwtMatrixRasterData::valueMatrix() const
 {
-    return m_data->values;
+    if ( m_data->valueType == Double && m_data->file == NULL )
+        return m_data->values;
+
+    QVector< double > values( m_data->numValues );
+    const MatrixView m = m_data->view();
+
+    for ( int i = 0; i < m_data->numValues; i++ )
+        values[i] = m.value( 0, i );
+
+    return values;
+}
+
+/*!
+   \return Type of the values in the matrix
+   \sa setValueMatrix(), setValueMatrixFile()
+ */
+QwtMatrixRasterData::ValueType QwtMatrixRasterData::valueType() const
+{
+    return m_data->valueType;
+}
+
+/*!
+   \return Factor for the values of integer matrices
+   \sa valueOffset(), valueType()
+ */
+double QwtMatrixRasterData::valueScale() const
+{
+    return m_data->scale;
+}
+
+/*!
+   \return Offset for the values of integer matrices
+   \sa valueScale(), valueType()
+ */
+double QwtMatrixRasterData::valueOffset() const
+{
+    return m_data->offset;
 }
 
 /*!
    \brief Change a single value in the matrix
 
+   For integer matrices the value is rounded to the
+   closest value, that can be stored. As there is no representation
+   for NaN in integer matrices, NaN values are ignored.
+
    \param row Row index
    \param col Column index
    \param value New value
 
+   \note Mapped files are read-only and can't be changed
    \sa value(), setValueMatrix()
  */
 void QwtMatrixRasterData::setValue( int row, int col, double value )
 {
+    if ( m_data->file )
+        return;
+
     if ( row >= 0 && row < m_data->numRows &&
         col >= 0 && col < m_data->numColumns )
     {
         const int index = row * m_data->numColumns + col;
-        m_data->values.data()[ index ] = value;
+
+        if ( qIsNaN( value ) &&
+            ( m_data->valueType == Int16 || m_data->valueType == UInt8 ) )
+        {
+            return;
+        }
+
+        m_data->clearLevels();
+
+        switch( m_data->valueType )
+        {
+            case Float:
+            {
+                m_data->floatValues.data()[ index ] = static_cast< float >( value );
+                m_data->matrix = m_data->floatValues.constData();
+                break;
+            }
+            case Int16:
+            {
+                // clamping before rounding, v might be out of the int range or +/-inf
+                const double v = qBound( -32768.0,
+                    ( value - m_data->offset ) / m_data->scale, 32767.0 );
+
+                m_data->int16Values.data()[ index ] = static_cast< qint16 >( qRound( v ) );
+                m_data->matrix = m_data->int16Values.constData();
+                break;
+            }
+            case UInt8:
+            {
+                const double v = qBound( 0.0,
+                    ( value - m_data->offset ) / m_data->scale, 255.0 );
+
+                m_data->uint8Values.data()[ index ] = static_cast< quint8 >( qRound( v ) );
+                m_data->matrix = m_data->uint8Values.constData();
+                break;
+            }
+            default:
+            {
+                m_data->values.data()[ index ] = value;
+                m_data->matrix = m_data->values.constData();
+            }
+        }
     }
 }
 
@@ -255,146 +1227,143 @@ QRectF QwtMatrixRasterData::pixelHint( const QRectF& area ) const
  */
 double QwtMatrixRasterData::value( double x, double y ) const
 {
-    const QwtInterval xInterval = interval( Qt::XAxis );
-    const QwtInterval yInterval = interval( Qt::YAxis );
-
-    if ( !( xInterval.contains(x) && yInterval.contains(y) ) )
-        return qQNaN();
-
-    double value;
-
-    switch( m_data->resampleMode )
-    {
-        case BicubicInterpolation:
-        {
-            const double colF = ( x - xInterval.minValue() ) / m_data->dx;
-            const double rowF = ( y - yInterval.minValue() ) / m_data->dy;
-
-            const int col = qRound( colF );
-            const int row = qRound( rowF );
-
-            int col0 = col - 2;
-            int col1 = col - 1;
-            int col2 = col;
-            int col3 = col + 1;
+    return qwtValue( m_data->resampleMode, m_data->view(),
+        interval( Qt::XAxis ), interval( Qt::YAxis ), x, y );
+}
 
-            if ( col1 < 0 )
-                col1 = col2;
+/*!
+   \brief Values for a list of positions
 
-            if ( col0 < 0 )
-                col0 = col1;
+   \param xValues X values in plot coordinates
+   \param yValues Y values in plot coordinates
+   \param numPoints Number of positions
+   \param values Array for numPoints values
 
-            if ( col2 >= m_data->numColumns )
-                col2 = col1;
+   \note pointValues() resamples the value matrix without calling value().
+         A derived class, that overrides value(), has to override
+         pointValues() as well - f.e. by calling QwtRasterData::pointValues().
 
-            if ( col3 >= m_data->numColumns )
-                col3 = col2;
+   \sa value(), ResampleMode
+ */
+void QwtMatrixRasterData::pointValues( const double* xValues,
+    const double* yValues, int numPoints, double* values ) const
+{
+    const ResampleMode mode = m_data->resampleMode;
+    const MatrixView m = m_data->view();
 
-            int row0 = row - 2;
-            int row1 = row - 1;
-            int row2 = row;
-            int row3 = row + 1;
+    const QwtInterval xInterval = interval( Qt::XAxis );
+    const QwtInterval yInterval = interval( Qt::YAxis );
 
-            if ( row1 < 0 )
-                row1 = row2;
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        values[i] = qwtValue( mode, m, xInterval,
+            yInterval, xValues[i], yValues[i] );
+    }
+}
 
-            if ( row0 < 0 )
-                row0 = row1;
+/*!
+   \brief Values for a grid of positions
+
+   The matrix indexes and interpolation parameters are calculated
+   once for each column and each row of the grid, so that resampling
+   a grid is significantly faster than calling value() for
+   each position.
+
+   \param xValues X values in plot coordinates
+   \param numColumns Number of x values
+   \param yValues Y values in plot coordinates
+   \param numRows Number of y values
+   \param values Array for numRows * numColumns values
+
+   When a pyramid mode is set, the level of the pyramid is selected
+   from the number of matrix values between neighboured positions.
+   The pixels of the selected level are never larger than the
+   distance between the positions, so that the resolution
+   recommended by pixelHint() is not affected.
+
+   \note values() resamples the value matrix without calling value().
+         A derived class, that overrides value(), has to override
+         values() as well - f.e. by calling QwtRasterData::values().
+
+   \sa value(), ResampleMode
+ */
+void QwtMatrixRasterData::values( const double* xValues, int numColumns,
+    const double* yValues, int numRows, double* values ) const
+{
+    if ( numColumns <= 0 || numRows <= 0 )
+        return;
 
-            if ( row2 >= m_data->numRows )
-                row2 = row1;
+    if ( m_data->numColumns <= 0 || m_data->numRows <= 0 )
+    {
+        std::fill( values, values + numColumns * numRows, qQNaN() );
+        return;
+    }
 
-            if ( row3 >= m_data->numRows )
-                row3 = row2;
+    int level = 0;
+    if ( m_data->pyramidMode != NoPyramid )
+    {
+        level = qwtPyramidLevel( xValues, numColumns, m_data->dx,
+            yValues, numRows, m_data->dy );
+    }
 
-            // First row
-            const double v00 = m_data->value( row0, col0 );
-            const double v10 = m_data->value( row0, col1 );
-            const double v20 = m_data->value( row0, col2 );
-            const double v30 = m_data->value( row0, col3 );
+    QSharedPointer< const PyramidLevel > pyramidLevel;
+    if ( level > 0 )
+        pyramidLevel = m_data->pyramidLevel( level );
 
-            // Second row
-            const double v01 = m_data->value( row1, col0 );
-            const double v11 = m_data->value( row1, col1 );
-            const double v21 = m_data->value( row1, col2 );
-            const double v31 = m_data->value( row1, col3 );
+    const ResampleMode mode = m_data->resampleMode;
+    const MatrixView m = pyramidLevel.isNull()
+        ? m_data->view() : m_data->view( *pyramidLevel );
 
-            // Third row
-            const double v02 = m_data->value( row2, col0 );
-            const double v12 = m_data->value( row2, col1 );
-            const double v22 = m_data->value( row2, col2 );
-            const double v32 = m_data->value( row2, col3 );
+    QVector< GridSample > xSamples( numColumns );
+    qwtGridSamples( mode, interval( Qt::XAxis ), m.dx,
+        m.numColumns, xValues, numColumns, xSamples.data() );
 
-            // Fourth row
-            const double v03 = m_data->value( row3, col0 );
-            const double v13 = m_data->value( row3, col1 );
-            const double v23 = m_data->value( row3, col2 );
-            const double v33 = m_data->value( row3, col3 );
+    QVector< GridSample > ySamples( numRows );
+    qwtGridSamples( mode, interval( Qt::YAxis ), m.dy,
+        m.numRows, yValues, numRows, ySamples.data() );
 
-            value = qwtBicubicInterpolate(
-                v00, v10, v20, v30, v01, v11, v21, v31,
-                v02, v12, v22, v32, v03, v13, v23, v33,
-                colF - col + 0.5, rowF - row + 0.5 );
+    const GridSample* xs = xSamples.constData();
+    const GridSample* ys = ySamples.constData();
+    const int stride = m.numColumns;
 
+    switch( m.type )
+    {
+        case Float:
+        {
+            qwtResampleGrid( mode, static_cast< const float* >( m.values ),
+                stride, xs, numColumns, ys, numRows, values );
             break;
         }
-        case BilinearInterpolation:
+        case Int16:
         {
-            int col1 = qRound( ( x - xInterval.minValue() ) / m_data->dx ) - 1;
-            int row1 = qRound( ( y - yInterval.minValue() ) / m_data->dy ) - 1;
-            int col2 = col1 + 1;
-            int row2 = row1 + 1;
-
-            if ( col1 < 0 )
-                col1 = col2;
-            else if ( col2 >= m_data->numColumns )
-                col2 = col1;
-
-            if ( row1 < 0 )
-                row1 = row2;
-            else if ( row2 >= m_data->numRows )
-                row2 = row1;
-
-            const double v11 = m_data->value( row1, col1 );
-            const double v21 = m_data->value( row1, col2 );
-            const double v12 = m_data->value( row2, col1 );
-            const double v22 = m_data->value( row2, col2 );
-
-            const double x2 = xInterval.minValue() + ( col2 + 0.5 ) * m_data->dx;
-            const double y2 = yInterval.minValue() + ( row2 + 0.5 ) * m_data->dy;
-
-            const double rx = ( x2 - x ) / m_data->dx;
-            const double ry = ( y2 - y ) / m_data->dy;
-
-            const double vr1 = rx * v11 + ( 1.0 - rx ) * v21;
-            const double vr2 = rx * v12 + ( 1.0 - rx ) * v22;
-
-            value = ry * vr1 + ( 1.0 - ry ) * vr2;
-
+            qwtResampleGrid( mode, static_cast< const qint16* >( m.values ),
+                stride, xs, numColumns, ys, numRows, values );
+            break;
+        }
+        case UInt8:
+        {
+            qwtResampleGrid( mode, static_cast< const quint8* >( m.values ),
+                stride, xs, numColumns, ys, numRows, values );
             break;
         }
-        case NearestNeighbour:
         default:
         {
-            int row = int( ( y - yInterval.minValue() ) / m_data->dy );
-            int col = int( ( x - xInterval.minValue() ) / m_data->dx );
-
-            // In case of intervals, where the maximum is included
-            // we get out of bound for row/col, when the value for the
-            // maximum is requested. Instead we return the value
-            // from the last row/col
+            qwtResampleGrid( mode, static_cast< const double* >( m.values ),
+                stride, xs, numColumns, ys, numRows, values );
+        }
+    }
 
-            if ( row >= m_data->numRows )
-                row = m_data->numRows - 1;
+    if ( m.scale != 1.0 || m.offset != 0.0 )
+    {
+        // the interpolations are linear in the values, so we can scale afterwards
 
-            if ( col >= m_data->numColumns )
-                col = m_data->numColumns - 1;
+        const double scale = m.scale;
+        const double offset = m.offset;
 
-            value = m_data->value( row, col );
-        }
+        const int numValues = numColumns * numRows;
+        for ( int i = 0; i < numValues; i++ )
+            values[i] = offset + scale * values[i];
     }
-
-    return value;
 }
 
 void QwtMatrixRasterData::update()
@@ -405,7 +1374,7 @@ void QwtMatrixRasterData::update()
 
     if ( m_data->numColumns > 0 )
     {
-        m_data->numRows = m_data->values.size() / m_data->numColumns;
+        m_data->numRows = m_data->numValues / m_data->numColumns;
 
         const QwtInterval xInterval = interval( Qt::XAxis );
         const QwtInterval yInterval = interval( Qt::YAxis );
@@ -415,3 +1384,24 @@ void QwtMatrixRasterData::update()
             m_data->dy = yInterval.width() / m_data->numRows;
     }
 }
+
+void QwtMatrixRasterData::resetValues()
+{
+    m_data->values.clear();
+    m_data->floatValues.clear();
+    m_data->int16Values.clear();
+    m_data->uint8Values.clear();
+
+    delete m_data->file;
+    m_data->file = NULL;
+
+    m_data->matrix = NULL;
+    m_data->numValues = 0;
+    m_data->numColumns = 0;
+
+    m_data->valueType = Double;
+    m_data->scale = 1.0;
+    m_data->offset = 0.0;
+
+    m_data->clearLevels();
+}
@@ -17,6 +17,8 @@
 template< typename T > class QVector;
 #endif
 
+class QString;
+
 /*!
    \brief A class representing a matrix of values as raster data
 
@@ -24,6 +26,23 @@ template< typename T > class QVector;
    equidistant values, that can be used by a QwtPlotRasterItem.
    It implements a couple of resampling algorithms, to provide
    values for positions, that or not on the value matrix.
+
+   For huge matrices the values can be stored in a compact type
+   ( float, qint16, quint8 ) instead of double. Integer values are
+   mapped by a linear transformation: value = offset + scale * storedValue.
+
+   A matrix can also be read from a memory mapped file
+   ( setValueMatrixFile() ), so that opening the file does not need
+   to load the values into memory. The values are read on demand
+   when resampling, so that the memory usage is bounded by the
+   page cache of the operating system.
+
+   When the matrix is rendered with a lower resolution, than it has,
+   downsampled levels of the matrix ( a pyramid ) can be used instead
+   of the matrix itself. This avoids aliasing and resampling
+   is faster as it runs on much less values.
+
+   \sa ValueType, PyramidMode
  */
 class QWT_EXPORT QwtMatrixRasterData : public QwtRasterData
 {
@@ -53,18 +72,79 @@ class QWT_EXPORT QwtMatrixRasterData : public QwtRasterData
         BicubicInterpolation
     };
 
+    /*!
+       \brief Type of the values in the matrix
+       \sa valueType(), setValueMatrix(), setValueMatrixFile()
+     */
+    enum ValueType
+    {
+        //! 64 bit floating point values
+        Double,
+
+        //! 32 bit floating point values
+        Float,
+
+        //! 16 bit signed integers mapped by scale and offset
+        Int16,
+
+        //! 8 bit unsigned integers mapped by scale and offset
+        UInt8
+    };
+
+    /*!
+       \brief Aggregation of the values for the downsampled levels
+
+       Each level of the pyramid has half of the columns and rows
+       of the previous level. A value of a level is calculated from
+       the 2x2 values of the previous level. NaN values are ignored.
+
+       The default setting is NoPyramid;
+       \sa setPyramidMode(), values()
+     */
+    enum PyramidMode
+    {
+        //! Always resample the value matrix
+        NoPyramid,
+
+        //! Average of the values
+        AveragePyramid,
+
+        //! Minimum of the values
+        MinimumPyramid,
+
+        //! Maximum of the values
+        MaximumPyramid
+    };
+
     QwtMatrixRasterData();
     virtual ~QwtMatrixRasterData();
 
     void setResampleMode(ResampleMode mode);
     ResampleMode resampleMode() const;
 
+    void setPyramidMode( PyramidMode );
+    PyramidMode pyramidMode() const;
+
     void setInterval( Qt::Axis, const QwtInterval& );
     virtual QwtInterval interval( Qt::Axis axis) const QWT_OVERRIDE QWT_FINAL;
 
     void setValueMatrix( const QVector< double >& values, int numColumns );
+    void setValueMatrix( const QVector< float >& values, int numColumns );
+
+    void setValueMatrix( const QVector< qint16 >& values, int numColumns,
+        double scale = 1.0, double offset = 0.0 );
+
+    void setValueMatrix( const QVector< quint8 >& values, int numColumns,
+        double scale = 1.0, double offset = 0.0 );
+
+    bool setValueMatrixFile( const QString& fileName );
+
     const QVector< double > valueMatrix() const;
 
+    ValueType valueType() const;
+    double valueScale() const;
+    double valueOffset() const;
+
     void setValue( int row, int col, double value );
 
     int numColumns() const;
@@ -74,8 +154,15 @@ class QWT_EXPORT QwtMatrixRasterData : public QwtRasterData
 
     virtual double value( double x, double y ) const QWT_OVERRIDE;
 
+    virtual void values( const double* xValues, int numColumns,
+        const double* yValues, int numRows, double* values ) const QWT_OVERRIDE;
+
+    virtual void pointValues( const double* xValues, const double* yValues,
+        int numPoints, double* values ) const QWT_OVERRIDE;
+
   private:
     void update();
+    void resetValues();
 
     class PrivateData;
     PrivateData* m_data;
@@ -1192,6 +1192,31 @@ void QwtPainter::drawRoundedFrame( QPainter* painter,
     painter->restore();
 }
 
+static QVector< QRgb > qwtColorBarRgbs( const QwtColorMap& colorMap,
+    const QwtInterval& interval, const QwtScaleMap& scaleMap, int from, int to )
+{
+    QVector< double > values( to - from + 1 );
+    for ( int i = 0; i < values.size(); i++ )
+        values[i] = scaleMap.invTransform( from + i );
+
+    QVector< QRgb > rgbs( values.size() );
+
+    if ( colorMap.format() == QwtColorMap::RGB )
+    {
+        colorMap.rgbValues( interval,
+            values.constData(), values.size(), rgbs.data() );
+    }
+    else
+    {
+        const QVector< QRgb > colorTable = colorMap.colorTable256();
+
+        for ( int i = 0; i < values.size(); i++ )
+            rgbs[i] = colorTable[ colorMap.colorIndex( 256, interval, values[i] ) ];
+    }
+
+    return rgbs;
+}
+
 /*!
    Draw a color bar into a rectangle
 
@@ -1207,10 +1232,6 @@ void QwtPainter::drawColorBar( QPainter* painter,
     const QwtScaleMap& scaleMap, Qt::Orientation orientation,
     const QRectF& rect )
 {
-    QVector< QRgb > colorTable;
-    if ( colorMap.format() == QwtColorMap::Indexed )
-        colorTable = colorMap.colorTable256();
-
     QColor c;
 
     const QRect devRect = rect.toAlignedRect();
@@ -1231,14 +1252,12 @@ void QwtPainter::drawColorBar( QPainter* painter,
         QwtScaleMap sMap = scaleMap;
         sMap.setPaintInterval( rect.left(), rect.right() );
 
+        const QVector< QRgb > rgbs = qwtColorBarRgbs( colorMap,
+            interval, sMap, devRect.left(), devRect.right() );
+
         for ( int x = devRect.left(); x <= devRect.right(); x++ )
         {
-            const double value = sMap.invTransform( x );
-
-            if ( colorMap.format() == QwtColorMap::RGB )
-                c.setRgba( colorMap.rgb( interval, value ) );
-            else
-                c = colorTable[colorMap.colorIndex( 256, interval, value )];
+            c.setRgba( rgbs[ x - devRect.left() ] );
 
             pmPainter.setPen( c );
             pmPainter.drawLine( x, devRect.top(), x, devRect.bottom() );
@@ -1249,14 +1268,12 @@ void QwtPainter::drawColorBar( QPainter* painter,
         QwtScaleMap sMap = scaleMap;
         sMap.setPaintInterval( rect.bottom(), rect.top() );
 
+        const QVector< QRgb > rgbs = qwtColorBarRgbs( colorMap,
+            interval, sMap, devRect.top(), devRect.bottom() );
+
         for ( int y = devRect.top(); y <= devRect.bottom(); y++ )
         {
-            const double value = sMap.invTransform( y );
-
-            if ( colorMap.format() == QwtColorMap::RGB )
-                c.setRgba( colorMap.rgb( interval, value ) );
-            else
-                c = colorTable[colorMap.colorIndex( 256, interval, value )];
+            c.setRgba( rgbs[ y - devRect.top() ] );
 
             pmPainter.setPen( c );
             pmPainter.drawLine( devRect.left(), y, devRect.right(), y );
@@ -10,10 +10,143 @@
 #include "qwt_plot_canvas.h"
 #include "qwt_painter.h"
 #include "qwt_plot.h"
+#include "qwt_plot_curve.h"
+#include "qwt_scale_map.h"
+#include "qwt_symbol.h"
 
 #include <qpainter.h>
 #include <qpainterpath.h>
 #include <qevent.h>
+#include <qhash.h>
+
+static inline bool qwtIsAppendOnly( const QwtPlotItem* item )
+{
+    if ( item->rtti() != QwtPlotItem::Rtti_PlotCurve || !item->isVisible() )
+        return false;
+
+    const QwtPlotCurve* curve = static_cast< const QwtPlotCurve* >( item );
+    return curve->testPaintAttribute( QwtPlotCurve::AppendOnly );
+}
+
+static inline bool qwtIsEqual( const QwtScaleMap& map1, const QwtScaleMap& map2 )
+{
+    /*
+        QwtTransform offers no access to its parameters - like the exponent
+        of a QwtPowerTransform. So maps with transformations can't be
+        compared and are always considered as being different.
+     */
+    if ( map1.transformation() || map2.transformation() )
+        return false;
+
+    return ( map1.s1() == map2.s1() ) && ( map1.s2() == map2.s2() )
+        && ( map1.p1() == map2.p1() ) && ( map1.p2() == map2.p2() );
+}
+
+/*
+   Checks if any item, that is painted on top of the curve, might
+   overlap with the curve. Items without a valid bounding rectangle
+   are expected to cover the complete canvas.
+ */
+static bool qwtIsCovered( const QwtPlotItemList& items, int index,
+    const QwtScaleMap maps[], const QRectF& canvasRect )
+{
+    const QwtPlotCurve* curve = static_cast< const QwtPlotCurve* >( items[index] );
+
+    QRectF curveRect = canvasRect;
+
+    const QRectF boundingRect = curve->boundingRect();
+    if ( boundingRect.width() >= 0.0 && boundingRect.height() >= 0.0 )
+    {
+        curveRect = QwtScaleMap::transform( maps[curve->xAxis()],
+            maps[curve->yAxis()], boundingRect ).normalized();
+
+        double margin = 0.5 * QwtPainter::effectivePenWidth( curve->pen() );
+
+        const QwtSymbol* symbol = curve->symbol();
+        if ( symbol && symbol->style() != QwtSymbol::NoSymbol )
+        {
+            const QSize size = symbol->size();
+            margin = qMax( margin, 0.5 * qMax( size.width(), size.height() ) );
+        }
+
+        margin += 1.0;
+
+        curveRect.adjust( -margin, -margin, margin, margin );
+        curveRect &= canvasRect;
+    }
+
+    // the items are sorted by z, the later ones are painted on top
+    for ( int i = index + 1; i < items.size(); i++ )
+    {
+        const QwtPlotItem* item = items[i];
+        if ( !item->isVisible() )
+            continue;
+
+        const QRectF rect = item->boundingRect();
+        if ( !rect.isValid() )
+            return true;
+
+        const QRectF itemRect = QwtScaleMap::transform( maps[item->xAxis()],
+            maps[item->yAxis()], rect ).normalized();
+
+        if ( itemRect.intersects( curveRect ) )
+            return true;
+    }
+
+    return false;
+}
+
+namespace
+{
+    class PaintedSamples
+    {
+      public:
+        PaintedSamples()
+            : size( 0 )
+            , revision( 0 )
+        {
+        }
+
+        PaintedSamples( const QwtPlotCurve* curve )
+            : size( curve->dataSize() )
+            , revision( curve->data()->revision() )
+        {
+        }
+
+        size_t size;
+        quint64 revision;
+    };
+}
+
+/*
+   Number of samples, that have been appended since the curve
+   has been painted, or -1 when the curve has been modified otherwise.
+   The appended samples are the last ones of the series.
+ */
+static qint64 qwtNumAppended( const QwtPlotCurve* curve,
+    const PaintedSamples& painted )
+{
+    const PaintedSamples current( curve );
+
+    if ( current.revision < painted.revision )
+        return -1;
+
+    const quint64 numAppended = current.revision - painted.revision;
+    if ( numAppended > current.size )
+        return -1;
+
+    /*
+        A series with a fixed capacity ( f.e. QwtRingBufferSeriesData )
+        drops its oldest samples, so we might have less samples than before.
+        But when all painted samples have been dropped - or when we have
+        more than before - the series has been modified otherwise.
+     */
+    const size_t numRetained = current.size - static_cast< size_t >( numAppended );
+    if ( numRetained > painted.size || ( numRetained == 0 && painted.size > 0 ) )
+        return -1;
+
+    return static_cast< qint64 >( numAppended );
+}
 
 class QwtPlotCanvas::PrivateData
 {
@@ -28,8 +161,34 @@ class QwtPlotCanvas::PrivateData
         delete backingStore;
     }
 
+    void updatePaintedSamples( const QwtPlot* plot, const QRect& rect )
+    {
+        canvasRect = rect;
+
+        for ( int axisPos = 0; axisPos < QwtAxis::AxisPositions; axisPos++ )
+            maps[axisPos] = plot->canvasMap( axisPos );
+
+        paintedSamples.clear();
+
+        const QwtPlotItemList& items = plot->itemList();
+        for ( int i = 0; i < items.size(); i++ )
+        {
+            const QwtPlotItem* item = items[i];
+            if ( qwtIsAppendOnly( item ) )
+            {
+                const QwtPlotCurve* curve = static_cast< const QwtPlotCurve* >( item );
+                paintedSamples.insert( curve, PaintedSamples( curve ) );
+            }
+        }
+    }
+
     QwtPlotCanvas::PaintAttributes paintAttributes;
     QPixmap* backingStore;
+
+    // state of the last complete paint operation into the backing store
+    QRect canvasRect;
+    QwtScaleMap maps[ QwtAxis::AxisPositions ];
+    QHash< const QwtPlotCurve*, PaintedSamples > paintedSamples;
 };
 
 /*!
@@ -211,6 +370,9 @@ void QwtPlotCanvas::paintEvent( QPaintEvent* event )
                 if ( frameWidth() > 0 )
                     drawBorder( &p );
             }
+
+            if ( plot() )
+                m_data->updatePaintedSamples( plot(), contentsRect() );
         }
 
         painter.drawPixmap( 0, 0, *m_data->backingStore );
@@ -308,6 +470,149 @@ void QwtPlotCanvas::replot()
         update( contentsRect() );
 }
 
+/*!
+   \brief Paint the samples, that have been appended since the last
+          paint operation
+
+   replotAppended() is intended for curves displaying the samples
+   of a running acquisition. Instead of repainting the complete canvas
+   only the samples of the curves with the QwtPlotCurve::AppendOnly
+   attribute, that have been appended since the last paint operation,
+   are painted into the backing store, that is copied to the canvas
+   afterwards. So the costs of an update depend on the number of new
+   samples and not on the size of the series.
+
+   The appended samples are detected by QwtSeriesData::revision(), so that
+   series with a fixed capacity ( f.e. QwtRingBufferSeriesData ), that
+   drop their oldest samples, are supported as well. Dropped samples
+   stay visible until the next complete replot.
+
+   Whenever the scales ( f.e. because of autoscaling ) or the geometry of
+   the canvas have changed since the last paint operation a complete
+   replot is done. This is also the case, when the backing store is disabled,
+   when curves have been attached or when a series has been modified
+   otherwise than by appending samples. As transformations can't be
+   compared, a complete replot is also done for any axis with a
+   transformation ( f.e. a logarithmic scale ).
+
+   As the new samples would be painted on top of all other items
+   a complete replot is also done, when any visible item with a higher z
+   value might overlap with the curve. Items, that don't have a valid
+   bounding rectangle ( f.e. QwtPlotGrid, QwtPlotLegendItem ), are expected
+   to cover the complete canvas.
+
+   \note All other plot items are expected to be unchanged.
+   \sa replot(), QwtPlotCurve::AppendOnly, QwtPlotDirectPainter
+ */
+void QwtPlotCanvas::replotAppended()
+{
+    QwtPlot* plot = this->plot();
+    if ( plot == NULL )
+        return;
+
+    // autoscaling might result in new scales
+    plot->updateAxes();
+
+    const QPixmap* bs = m_data->backingStore;
+
+    bool doReplot = !( testPaintAttribute( QwtPlotCanvas::BackingStore )
+        && bs && bs->size() == size() * QwtPainter::devicePixelRatio( bs ) );
+
+    const QRect canvasRect = contentsRect();
+    if ( canvasRect != m_data->canvasRect )
+        doReplot = true;
+
+    for ( int axisPos = 0; !doReplot && axisPos < QwtAxis::AxisPositions; axisPos++ )
+    {
+        if ( !qwtIsEqual( plot->canvasMap( axisPos ), m_data->maps[axisPos] ) )
+            doReplot = true;
+    }
+
+    QVector< const QwtPlotCurve* > curves;
+
+    const QwtPlotItemList& items = plot->itemList();
+    for ( int i = 0; !doReplot && i < items.size(); i++ )
+    {
+        const QwtPlotItem* item = items[i];
+        if ( !qwtIsAppendOnly( item ) )
+            continue;
+
+        const QwtPlotCurve* curve = static_cast< const QwtPlotCurve* >( item );
+
+        if ( !m_data->paintedSamples.contains( curve )
+            || qwtNumAppended( curve, m_data->paintedSamples.value( curve ) ) < 0
+            || ( curve->style() == QwtPlotCurve::Lines
+                && curve->testCurveAttribute( QwtPlotCurve::Fitted ) )
+            || qwtIsCovered( items, i, m_data->maps, canvasRect ) )
+        {
+            doReplot = true;
+        }
+        else
+        {
+            curves += curve;
+        }
+    }
+
+    if ( doReplot )
+    {
+        plot->replot();
+        return;
+    }
+
+    QPainter painter( m_data->backingStore );
+    painter.setClipRect( canvasRect );
+
+    const QPainterPath clipPath = borderPath( rect() );
+    if ( !clipPath.isEmpty() )
+        painter.setClipPath( clipPath, Qt::IntersectClip );
+
+    bool isUpdated = false;
+
+    for ( int i = 0; i < curves.size(); i++ )
+    {
+        const QwtPlotCurve* curve = curves[i];
+
+        const int numAppended = static_cast< int >(
+            qwtNumAppended( curve, m_data->paintedSamples.value( curve ) ) );
+
+        if ( numAppended <= 0 )
+            continue;
+
+        const int numSamples = static_cast< int >( curve->dataSize() );
+        int from = numSamples - numAppended;
+
+        // connecting the new samples to the last painted one
+        if ( from > 0 && ( curve->style() == QwtPlotCurve::Lines
+            || curve->style() == QwtPlotCurve::Steps ) )
+        {
+            from--;
+        }
+
+        painter.save();
+
+        painter.setRenderHint( QPainter::Antialiasing,
+            curve->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+
+        curve->drawSeries( &painter, m_data->maps[curve->xAxis()],
+            m_data->maps[curve->yAxis()], canvasRect, from, numSamples - 1 );
+
+        painter.restore();
+
+        m_data->paintedSamples.insert( curve, PaintedSamples( curve ) );
+        isUpdated = true;
+    }
+
+    painter.end();
+
+    if ( isUpdated )
+    {
+        if ( testPaintAttribute( QwtPlotCanvas::ImmediatePaint ) )
+            repaint( canvasRect );
+        else
+            update( canvasRect );
+    }
+}
+
 /*!
    Calculate the painter path for a styled or rounded border
 
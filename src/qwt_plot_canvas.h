@@ -116,6 +116,7 @@ class QWT_EXPORT QwtPlotCanvas : public QFrame, public QwtPlotAbstractCanvas
 
   public Q_SLOTS:
     void replot();
+    void replotAppended();
 
   protected:
     virtual void paintEvent( QPaintEvent* ) QWT_OVERRIDE;
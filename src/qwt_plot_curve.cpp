@@ -15,15 +15,29 @@
 #include "qwt_scale_map.h"
 #include "qwt_plot.h"
 #include "qwt_spline_curve_fitter.h"
+#include "qwt_spline.h"
 #include "qwt_symbol.h"
 #include "qwt_point_mapper.h"
+#include "qwt_color_map.h"
+#include "qwt_transform.h"
+#include "qwt_point_index.h"
 #include "qwt_text.h"
 #include "qwt_graphic.h"
 
 #include <qpainter.h>
 #include <qpainterpath.h>
+#include <qtransform.h>
+
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
 
 #include <climits>
+#include <algorithm>
+
+#if !defined( QT_NO_QFUTURE )
+#define QWT_USE_THREADS 1
+#endif
 
 static inline QRectF qwtIntersectedClipRect( const QRectF& rect, QPainter* painter )
 {
@@ -34,6 +48,205 @@ static inline QRectF qwtIntersectedClipRect( const QRectF& rect, QPainter* paint
     return clipRect;
 }
 
+static inline bool qwtIntersects( const QPointF* points, int numPoints,
+    const QRectF& rect )
+{
+    double x1 = points[0].x();
+    double x2 = x1;
+    double y1 = points[0].y();
+    double y2 = y1;
+
+    for ( int i = 1; i < numPoints; i++ )
+    {
+        x1 = qMin( x1, points[i].x() );
+        x2 = qMax( x2, points[i].x() );
+        y1 = qMin( y1, points[i].y() );
+        y2 = qMax( y2, points[i].y() );
+    }
+
+    // QRectF::intersects() fails for horizontal or vertical lines
+    return ( x1 <= rect.right() ) && ( x2 >= rect.left() )
+        && ( y1 <= rect.bottom() ) && ( y2 >= rect.top() );
+}
+
+/*
+   Removing the segments of a path, that are outside of a rectangle.
+   As a bezier curve is inside of the convex hull of its control points,
+   the segments, where the control points are outside, can be dropped.
+ */
+static QPainterPath qwtClippedPath( const QRectF& clipRect, const QPainterPath& path )
+{
+    QPainterPath clippedPath;
+
+    QPointF points[4];
+    bool isConnected = false;
+
+    for ( int i = 0; i < path.elementCount(); i++ )
+    {
+        const QPainterPath::Element& element = path.elementAt( i );
+
+        if ( element.type == QPainterPath::MoveToElement )
+        {
+            points[0] = element;
+            isConnected = false;
+
+            continue;
+        }
+
+        int numPoints = 2;
+        points[1] = element;
+
+        if ( element.type == QPainterPath::CurveToElement
+            && i + 2 < path.elementCount() )
+        {
+            points[2] = path.elementAt( ++i );
+            points[3] = path.elementAt( ++i );
+
+            numPoints = 4;
+        }
+
+        if ( qwtIntersects( points, numPoints, clipRect ) )
+        {
+            if ( !isConnected )
+                clippedPath.moveTo( points[0] );
+
+            if ( numPoints == 4 )
+                clippedPath.cubicTo( points[1], points[2], points[3] );
+            else
+                clippedPath.lineTo( points[1] );
+
+            isConnected = true;
+        }
+        else
+        {
+            isConnected = false;
+        }
+
+        points[0] = points[numPoints - 1];
+    }
+
+    return clippedPath;
+}
+
+static QPolygonF qwtClippedPolylineF( const QRectF& clipRect,
+    const QPolygonF& polyline, int from, int to )
+{
+    QPolygonF points( to - from + 1 );
+    std::copy( polyline.constData() + from,
+        polyline.constData() + to + 1, points.data() );
+
+    QwtClipper::clipPolygonF( clipRect, points, false );
+    return points;
+}
+
+/*
+    Clipping a polyline in chunks, that are processed in parallel.
+
+    The chunks are split at points being inside of the clip rectangle,
+    what are the first/last points of the clipped chunks. So the chunks
+    can be joined without modifying the result.
+ */
+static void qwtClipPolylineF( const QRectF& clipRect,
+    QPolygonF& polyline, uint numThreads )
+{
+#if QWT_USE_THREADS
+    // not worth the overhead of a thread for less points
+    const int minChunkSize = 10000;
+
+    const int numPoints = polyline.size();
+
+    int numChunks = numThreads;
+    if ( numChunks == 0 )
+        numChunks = QThread::idealThreadCount();
+
+    numChunks = qMin( numChunks, numPoints / minChunkSize );
+
+    if ( numChunks > 1 )
+    {
+        const QPointF* points = polyline.constData();
+        const int chunkSize = numPoints / numChunks;
+
+        QVector< int > splitIndexes;
+        splitIndexes += 0;
+
+        for ( int i = 1; i < numChunks; i++ )
+        {
+            int index = qMax( i * chunkSize, splitIndexes.last() + 1 );
+            while ( index < numPoints - 1 && !clipRect.contains( points[index] ) )
+                index++;
+
+            if ( index >= numPoints - 1 )
+                break;
+
+            splitIndexes += index;
+        }
+
+        if ( splitIndexes.size() > 1 )
+        {
+            splitIndexes += numPoints - 1;
+
+            QList< QFuture< QPolygonF > > futures;
+            for ( int i = 0; i < splitIndexes.size() - 2; i++ )
+            {
+                futures += QtConcurrent::run( &qwtClippedPolylineF,
+                    clipRect, polyline, splitIndexes[i], splitIndexes[i + 1] );
+            }
+
+            const QPolygonF lastChunk = qwtClippedPolylineF( clipRect, polyline,
+                splitIndexes[splitIndexes.size() - 2], splitIndexes.last() );
+
+            QPolygonF clipped;
+            for ( int i = 0; i <= futures.size(); i++ )
+            {
+                const QPolygonF chunk = ( i < futures.size() )
+                    ? futures[i].result() : lastChunk;
+
+                if ( clipped.isEmpty() )
+                {
+                    clipped = chunk;
+                }
+                else if ( chunk.size() > 1 )
+                {
+                    // the split point is the first point of the chunk and
+                    // has already been added as last point of the previous one
+
+                    const int size0 = clipped.size();
+                    clipped.resize( size0 + chunk.size() - 1 );
+
+                    std::copy( chunk.constData() + 1,
+                        chunk.constData() + chunk.size(), clipped.data() + size0 );
+                }
+            }
+
+            polyline = clipped;
+            return;
+        }
+    }
+#else
+    Q_UNUSED( numThreads )
+#endif
+
+    QwtClipper::clipPolygonF( clipRect, polyline, false );
+}
+
+static bool qwtLinearTransform( const QwtScaleMap& xMap,
+    const QwtScaleMap& yMap, QTransform& transform )
+{
+    if ( xMap.transformation() || yMap.transformation() )
+        return false;
+
+    if ( xMap.sDist() == 0.0 || yMap.sDist() == 0.0 )
+        return false;
+
+    const double sx = ( xMap.p2() - xMap.p1() ) / ( xMap.s2() - xMap.s1() );
+    const double sy = ( yMap.p2() - yMap.p1() ) / ( yMap.s2() - yMap.s1() );
+
+    transform.setMatrix( sx, 0.0, 0.0, 0.0, sy, 0.0,
+        xMap.p1() - xMap.s1() * sx, yMap.p1() - yMap.s1() * sy, 1.0 );
+
+    return true;
+}
+
 static void qwtUpdateLegendIconSize( QwtPlotCurve* curve )
 {
     if ( curve->symbol() &&
@@ -78,8 +291,15 @@ class QwtPlotCurve::PrivateData
         : style( QwtPlotCurve::Lines )
         , baseline( 0.0 )
         , symbol( NULL )
+        , densityColorMap( NULL )
+        , densityTransformation( NULL )
         , pen( Qt::black )
         , paintAttributes( QwtPlotCurve::ClipPolygons | QwtPlotCurve::FilterPoints )
+        , spatialIndexEnabled( false )
+        , indexedSeries( NULL )
+        , indexedRevision( 0 )
+        , fittedSeries( NULL )
+        , fittedRevision( 0 )
     {
         curveFitter = new QwtSplineCurveFitter;
     }
@@ -88,6 +308,53 @@ class QwtPlotCurve::PrivateData
     {
         delete symbol;
         delete curveFitter;
+        delete densityColorMap;
+        delete densityTransformation;
+    }
+
+    const QwtPointIndex& spatialIndex( const QwtSeriesData< QPointF >* series )
+    {
+        // the index is built lazily, when it is needed for the first time
+
+        if ( pointIndex.isNull() || series != indexedSeries
+            || series->revision() != indexedRevision )
+        {
+            pointIndex.setSamples( series );
+
+            indexedSeries = series;
+            indexedRevision = series->revision();
+        }
+
+        return pointIndex;
+    }
+
+    const QPainterPath& fittedCurvePath( const QwtSeriesData< QPointF >* series )
+    {
+        // the curve is fitted in scale coordinates, what needs to
+        // be done once for each revision of the data only
+
+        if ( series != fittedSeries || series->revision() != fittedRevision )
+        {
+            const int numPoints = static_cast< int >( series->size() );
+
+            QPolygonF points( numPoints );
+            for ( int i = 0; i < numPoints; i++ )
+                points[i] = series->sample( i );
+
+            fittedPath = curveFitter->fitCurvePath( points );
+
+            fittedSeries = series;
+            fittedRevision = series->revision();
+        }
+
+        return fittedPath;
+    }
+
+    void resetFittedCurvePath()
+    {
+        fittedPath = QPainterPath();
+        fittedSeries = NULL;
+        fittedRevision = 0;
     }
 
     QwtPlotCurve::CurveStyle style;
@@ -96,6 +363,9 @@ class QwtPlotCurve::PrivateData
     const QwtSymbol* symbol;
     QwtCurveFitter* curveFitter;
 
+    QwtColorMap* densityColorMap;
+    QwtTransform* densityTransformation;
+
     QPen pen;
     QBrush brush;
 
@@ -103,6 +373,15 @@ class QwtPlotCurve::PrivateData
     QwtPlotCurve::PaintAttributes paintAttributes;
 
     QwtPlotCurve::LegendAttributes legendAttributes;
+
+    bool spatialIndexEnabled;
+    QwtPointIndex pointIndex;
+    const QwtSeriesData< QPointF >* indexedSeries;
+    quint64 indexedRevision;
+
+    QPainterPath fittedPath;
+    const QwtSeriesData< QPointF >* fittedSeries;
+    quint64 fittedRevision;
 };
 
 /*!
@@ -162,6 +441,9 @@ void QwtPlotCurve::setPaintAttribute( PaintAttribute attribute, bool on )
         m_data->paintAttributes |= attribute;
     else
         m_data->paintAttributes &= ~attribute;
+
+    if ( attribute == CacheFittedCurve )
+        m_data->resetFittedCurvePath();
 }
 
 /*!
@@ -465,6 +747,11 @@ void QwtPlotCurve::drawCurve( QPainter* painter, int style,
    If the CurveAttribute Fitted is enabled a QwtCurveFitter tries
    to interpolate/smooth the curve, before it is painted.
 
+   For a QwtSplineCurveFitter with a local spline only the visible
+   parts of the curve are fitted, when ClipPolygons is enabled.
+   With CacheFittedCurve the fitted curve is reused for all scale
+   maps without transformation.
+
    \param painter Painter
    \param xMap x map
    \param yMap y map
@@ -496,6 +783,25 @@ void QwtPlotCurve::drawLines( QPainter* painter,
         clipRect = clipRect.adjusted(-pw, -pw, pw, pw);
     }
 
+    if ( doFit && !doFill && testPaintAttribute( CacheFittedCurve )
+        && m_data->curveFitter->mode() == QwtCurveFitter::Path
+        && from == 0 && to == static_cast< int >( dataSize() ) - 1 )
+    {
+        QTransform transform;
+        if ( qwtLinearTransform( xMap, yMap, transform ) )
+        {
+            QPainterPath curvePath =
+                transform.map( m_data->fittedCurvePath( data() ) );
+
+            if ( m_data->paintAttributes & ClipPolygons )
+                curvePath = qwtClippedPath( clipRect, curvePath );
+
+            painter->drawPath( curvePath );
+
+            return;
+        }
+    }
+
     QwtPointMapper mapper;
 
     if ( doAlign )
@@ -511,7 +817,8 @@ void QwtPlotCurve::drawLines( QPainter* painter,
 
     mapper.setBoundingRect( canvasRect );
 
-    QPolygonF polyline = mapper.toPolygonF( xMap, yMap, data(), from, to );
+    QPolygonF polyline = mapper.toPolygonF(
+        xMap, yMap, data(), from, to, renderThreadCount() );
 
     if ( doFill )
     {
@@ -534,7 +841,7 @@ void QwtPlotCurve::drawLines( QPainter* painter,
             filled.clear();
 
             if ( m_data->paintAttributes & ClipPolygons )
-                QwtClipper::clipPolygonF( clipRect, polyline, false );
+                qwtClipPolylineF( clipRect, polyline, renderThreadCount() );
 
             QwtPainter::drawPolyline( painter, polyline );
         }
@@ -545,9 +852,24 @@ void QwtPlotCurve::drawLines( QPainter* painter,
     }
     else
     {
+        const QwtSplineCurveFitter* splineFitter = doFit
+            ? dynamic_cast< const QwtSplineCurveFitter* >( m_data->curveFitter ) : NULL;
+
+        if ( splineFitter && splineFitter->spline()
+            && splineFitter->spline()->locality() > 0
+            && testPaintAttribute( ClipPolygons ) )
+        {
+            // fitting the visible parts of the polyline only
+            const QPainterPath curvePath =
+                splineFitter->fitCurvePath( polyline, clipRect );
+
+            painter->drawPath( curvePath );
+            return;
+        }
+
         if ( testPaintAttribute( ClipPolygons ) )
         {
-            QwtClipper::clipPolygonF( clipRect, polyline, false );
+            qwtClipPolylineF( clipRect, polyline, renderThreadCount() );
         }
 
         if ( doFit )
@@ -605,18 +927,16 @@ void QwtPlotCurve::drawSticks( QPainter* painter,
 
     const Qt::Orientation o = orientation();
 
-    const QwtSeriesData< QPointF >* series = data();
+    QwtPointMapper mapper;
+    mapper.setFlag( QwtPointMapper::RoundPoints, doAlign );
 
-    for ( int i = from; i <= to; i++ )
+    const QPolygonF points = mapper.toPolygonF(
+        xMap, yMap, data(), from, to, renderThreadCount() );
+
+    for ( int i = 0; i < points.size(); i++ )
     {
-        const QPointF sample = series->sample( i );
-        double xi = xMap.transform( sample.x() );
-        double yi = yMap.transform( sample.y() );
-        if ( doAlign )
-        {
-            xi = qRound( xi );
-            yi = qRound( yi );
-        }
+        const double xi = points[i].x();
+        const double yi = points[i].y();
 
         if ( o == Qt::Horizontal )
             QwtPainter::drawLine( painter, x0, yi, xi, yi );
@@ -677,6 +997,14 @@ void QwtPlotCurve::drawDots( QPainter* painter,
         QwtPainter::drawPoints( painter, points );
         fillCurve( painter, xMap, yMap, canvasRect, points );
     }
+    else if ( ( m_data->paintAttributes & ImageBuffer ) && m_data->densityColorMap )
+    {
+        const QImage image = mapper.toDensityImage( xMap, yMap,
+            data(), from, to, *m_data->densityColorMap,
+            m_data->densityTransformation, renderThreadCount() );
+
+        painter->drawImage( canvasRect.toAlignedRect(), image );
+    }
     else if ( m_data->paintAttributes & ImageBuffer )
     {
         const QImage image = mapper.toImage( xMap, yMap,
@@ -753,19 +1081,16 @@ void QwtPlotCurve::drawSteps( QPainter* painter,
     if ( m_data->attributes & Inverted )
         inverted = !inverted;
 
-    const QwtSeriesData< QPointF >* series = data();
+    QwtPointMapper mapper;
+    mapper.setFlag( QwtPointMapper::RoundPoints, doAlign );
+
+    const QPolygonF mappedPoints = mapper.toPolygonF(
+        xMap, yMap, data(), from, to, renderThreadCount() );
 
-    int i, ip;
-    for ( i = from, ip = 0; i <= to; i++, ip += 2 )
+    for ( int i = 0, ip = 0; i < mappedPoints.size(); i++, ip += 2 )
     {
-        const QPointF sample = series->sample( i );
-        double xi = xMap.transform( sample.x() );
-        double yi = yMap.transform( sample.y() );
-        if ( doAlign )
-        {
-            xi = qRound( xi );
-            yi = qRound( yi );
-        }
+        const double xi = mappedPoints[i].x();
+        const double yi = mappedPoints[i].y();
 
         if ( ip > 0 )
         {
@@ -795,8 +1120,8 @@ void QwtPlotCurve::drawSteps( QPainter* painter,
         const qreal pw = QwtPainter::effectivePenWidth( painter->pen() );
         clipRect = clipRect.adjusted(-pw, -pw, pw, pw);
 
-        const QPolygonF clipped = QwtClipper::clippedPolygonF(
-            clipRect, polygon, false );
+        QPolygonF clipped = polygon;
+        qwtClipPolylineF( clipRect, clipped, renderThreadCount() );
 
         QwtPainter::drawPolyline( painter, clipped );
     }
@@ -862,6 +1187,8 @@ void QwtPlotCurve::setCurveFitter( QwtCurveFitter* curveFitter )
     delete m_data->curveFitter;
     m_data->curveFitter = curveFitter;
 
+    m_data->resetFittedCurvePath();
+
     itemChanged();
 }
 
@@ -876,6 +1203,77 @@ QwtCurveFitter* QwtPlotCurve::curveFitter() const
     return m_data->curveFitter;
 }
 
+/*!
+   \brief Assign a color map for displaying the density of dots
+
+   For curves in QwtPlotCurve::Dots style with the ImageBuffer
+   paint attribute the number of points, that are mapped to each pixel,
+   is counted. The color map translates the counts into colors, where the
+   interval of the color map is [ 1, maximum count ] of the image.
+   Pixels without any point remain transparent.
+
+   Counting the points is done in parallel by renderThreadCount()
+   threads, what makes the density mode suitable for scatter plots
+   with a huge number of points.
+
+   \param colorMap Color map, NULL disables the density mode.
+                   The curve takes ownership of the color map.
+
+   \sa densityColorMap(), setDensityTransformation(),
+       QwtPointMapper::toDensityImage()
+ */
+void QwtPlotCurve::setDensityColorMap( QwtColorMap* colorMap )
+{
+    if ( colorMap != m_data->densityColorMap )
+    {
+        delete m_data->densityColorMap;
+        m_data->densityColorMap = colorMap;
+
+        itemChanged();
+    }
+}
+
+/*!
+   \return Color map for displaying the density of dots
+   \sa setDensityColorMap()
+ */
+const QwtColorMap* QwtPlotCurve::densityColorMap() const
+{
+    return m_data->densityColorMap;
+}
+
+/*!
+   \brief Assign a transformation for the counts of the density mode
+
+   The counts are transformed before they are mapped to colors. F.e.
+   a QwtLogTransform makes sparse regions visible, when the counts
+   in dense regions are magnitudes higher.
+
+   \param transformation Transformation, NULL means linear.
+                         The curve takes ownership of the transformation.
+
+   \sa densityTransformation(), setDensityColorMap()
+ */
+void QwtPlotCurve::setDensityTransformation( QwtTransform* transformation )
+{
+    if ( transformation != m_data->densityTransformation )
+    {
+        delete m_data->densityTransformation;
+        m_data->densityTransformation = transformation;
+
+        itemChanged();
+    }
+}
+
+/*!
+   \return Transformation for the counts of the density mode
+   \sa setDensityTransformation()
+ */
+const QwtTransform* QwtPlotCurve::densityTransformation() const
+{
+    return m_data->densityTransformation;
+}
+
 /*!
    Fill the area between the curve and the baseline with
    the curve brush
@@ -991,6 +1389,14 @@ void QwtPlotCurve::drawSymbols( QPainter* painter, const QwtSymbol& symbol,
     const QRectF clipRect = qwtIntersectedClipRect( canvasRect, painter );
     mapper.setBoundingRect( clipRect );
 
+    if ( ( m_data->paintAttributes & SymbolImageBuffer ) &&
+        QwtPainter::roundingAlignment( painter ) &&
+        painter->transform().type() <= QTransform::TxTranslate )
+    {
+        drawSymbolImage( painter, symbol, xMap, yMap, clipRect, from, to );
+        return;
+    }
+
     const int chunkSize = 500;
 
     for ( int i = from; i <= to; i += chunkSize )
@@ -1005,6 +1411,59 @@ void QwtPlotCurve::drawSymbols( QPainter* painter, const QwtSymbol& symbol,
     }
 }
 
+void QwtPlotCurve::drawSymbolImage( QPainter* painter, const QwtSymbol& symbol,
+    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+    const QRectF& clipRect, int from, int to ) const
+{
+    const QRect rect = clipRect.toAlignedRect();
+    const QRect br = symbol.boundingRect();
+
+    if ( rect.isEmpty() || br.isEmpty() )
+        return;
+
+    qreal pixelRatio = 1.0;
+#if QT_VERSION >= 0x050000
+    pixelRatio = QwtPainter::devicePixelRatio( painter->device() );
+#endif
+
+    // the sprite, in resolution of the paint device
+
+    QImage sprite( qwtCeil( br.width() * pixelRatio ),
+        qwtCeil( br.height() * pixelRatio ), QImage::Format_ARGB32_Premultiplied );
+    sprite.fill( 0u );
+
+    {
+        QPainter p( &sprite );
+        p.setRenderHints( painter->renderHints() );
+        p.scale( pixelRatio, pixelRatio );
+        p.translate( -br.topLeft() );
+
+        symbol.drawSymbol( &p, QPointF( 0.0, 0.0 ) );
+    }
+
+    const QPoint hotSpot( qRound( -br.left() * pixelRatio ),
+        qRound( -br.top() * pixelRatio ) );
+
+    QwtScaleMap xxMap = xMap;
+    xxMap.setPaintInterval( xMap.p1() * pixelRatio, xMap.p2() * pixelRatio );
+
+    QwtScaleMap yyMap = yMap;
+    yyMap.setPaintInterval( yMap.p1() * pixelRatio, yMap.p2() * pixelRatio );
+
+    QwtPointMapper mapper;
+    mapper.setBoundingRect( QRectF( rect.x() * pixelRatio, rect.y() * pixelRatio,
+        rect.width() * pixelRatio, rect.height() * pixelRatio ) );
+
+    QImage image = mapper.toImage( xxMap, yyMap, data(), from, to,
+        sprite, hotSpot, renderThreadCount() );
+
+#if QT_VERSION >= 0x050000
+    image.setDevicePixelRatio( pixelRatio );
+#endif
+
+    painter->drawImage( rect.topLeft(), image );
+}
+
 /*!
    \brief Set the value of the baseline
 
@@ -1047,8 +1506,10 @@ double QwtPlotCurve::baseline() const
               the position and the closest curve point in paint device coordinates
    \return Index of the closest curve point, or -1 if none can be found
           ( f.e when the curve has no points )
-   \note closestPoint() implements a dumb algorithm, that iterates
-        over all points
+   \note Unless the spatial index is enabled closestPoint() implements
+         a dumb algorithm, that iterates over all points
+
+   \sa setSpatialIndexEnabled()
  */
 int QwtPlotCurve::closestPoint( const QPointF& pos, double* dist ) const
 {
@@ -1066,6 +1527,12 @@ int QwtPlotCurve::closestPoint( const QPointF& pos, double* dist ) const
     const QwtScaleMap xMap = plot->canvasMap( xAxis() );
     const QwtScaleMap yMap = plot->canvasMap( yAxis() );
 
+    if ( m_data->spatialIndexEnabled )
+    {
+        const QwtPointIndex& index = m_data->spatialIndex( series );
+        return index.closestPoint( xMap, yMap, pos, dist );
+    }
+
     int index = -1;
     double dmin = 1.0e10;
 
@@ -1089,6 +1556,113 @@ int QwtPlotCurve::closestPoint( const QPointF& pos, double* dist ) const
     return index;
 }
 
+/*!
+   Find all curve points inside of a rectangle
+
+   pointsInRect() is intended for selecting points with a rubber band,
+   f.e. the rectangle of QwtPlotPicker::selected().
+
+   \param rect Rectangle in scale coordinates. Points on the border
+               of the rectangle are considered as being inside.
+
+   \return Indices of the curve points in increasing order
+
+   \note Unless the spatial index is enabled pointsInRect() iterates
+         over all points
+
+   \sa setSpatialIndexEnabled(), closestPoint()
+ */
+QVector< int > QwtPlotCurve::pointsInRect( const QRectF& rect ) const
+{
+    QVector< int > indices;
+
+    const QwtSeriesData< QPointF >* series = data();
+    if ( series == NULL )
+        return indices;
+
+    if ( m_data->spatialIndexEnabled )
+        return m_data->spatialIndex( series ).pointsInRect( rect );
+
+    const QRectF r = rect.normalized();
+
+    const int numSamples = static_cast< int >( series->size() );
+    for ( int i = 0; i < numSamples; i++ )
+    {
+        const QPointF sample = series->sample( i );
+
+        if ( sample.x() >= r.left() && sample.x() <= r.right()
+            && sample.y() >= r.top() && sample.y() <= r.bottom() )
+        {
+            indices += i;
+        }
+    }
+
+    return indices;
+}
+
+/*!
+   \brief En/Disable a spatial index for the curve points
+
+   When enabled, closestPoint() and pointsInRect() use a k-d tree
+   of the curve points, that finds the points in logarithmic time.
+   This is recommended for curves with many points, that are
+   queried frequently - f.e. by a picker tracking the mouse.
+
+   The index is built lazily by the first query after the samples
+   have been changed and holds a copy of the points.
+
+   \note When the points of the series are modified without calling
+         setSamples() or setData() the index is not updated - unless
+         the revision of the series ( QwtSeriesData::revision() )
+         has changed.
+
+   \param on On/Off
+   \sa isSpatialIndexEnabled(), QwtPointIndex
+ */
+void QwtPlotCurve::setSpatialIndexEnabled( bool on )
+{
+    if ( on != m_data->spatialIndexEnabled )
+    {
+        m_data->spatialIndexEnabled = on;
+
+        if ( !on )
+            m_data->pointIndex.reset();
+    }
+}
+
+/*!
+   \return True, when the spatial index is enabled
+   \sa setSpatialIndexEnabled()
+ */
+bool QwtPlotCurve::isSpatialIndexEnabled() const
+{
+    return m_data->spatialIndexEnabled;
+}
+
+/*!
+   Invalidate the spatial index, when the series has been changed
+   \sa setSpatialIndexEnabled()
+ */
+void QwtPlotCurve::dataChanged()
+{
+    m_data->pointIndex.reset();
+    m_data->resetFittedCurvePath();
+
+    QwtPlotSeriesItem::dataChanged();
+}
+
+/*!
+   Invalidate the cache of the fitted curve and call
+   QwtPlotSeriesItem::itemChanged()
+
+   \sa CacheFittedCurve
+ */
+void QwtPlotCurve::itemChanged()
+{
+    m_data->resetFittedCurvePath();
+    QwtPlotSeriesItem::itemChanged();
+}
+
 /*!
    Find the curve point with the smallest coordinate larger than a specific value
    The coordinates have to be monotonic in direction of the orientation.
@@ -18,6 +18,8 @@
 class QwtScaleMap;
 class QwtSymbol;
 class QwtCurveFitter;
+class QwtColorMap;
+class QwtTransform;
 template< typename T > class QwtSeriesData;
 class QwtText;
 class QPainter;
@@ -203,6 +205,11 @@ class QWT_EXPORT QwtPlotCurve
            having a huge amount of points.
            With a reasonable number of points QPainter::drawPoints()
            will be faster.
+
+           When a density color map has been assigned, the number of points
+           mapped to each pixel is counted and displayed by the color map.
+
+           \sa setDensityColorMap()
          */
         ImageBuffer = 0x08,
 
@@ -229,6 +236,66 @@ class QWT_EXPORT QwtPlotCurve
                 worked around by enabling the QwtPainter::polylineSplitting() mode.
          */
         FilterPointsAggressive = 0x10,
+
+        /*!
+           Samples are only appended to the series - never inserted,
+           removed or modified. A series with a fixed capacity might drop
+           its oldest samples, when its QwtSeriesData::revision() counts
+           the appended samples.
+
+           For curves with this attribute QwtPlotCanvas::replotAppended()
+           paints only the samples, that have been appended since
+           the last paint operation, into the backing store of the canvas.
+
+           \note Curves with QwtPlotCurve::Fitted can't be painted
+                 incrementally and always lead to a complete replot.
+           \sa QwtPlotCanvas::replotAppended()
+         */
+        AppendOnly = 0x20,
+
+        /*!
+           Render the symbols to a temporary image and paint the image.
+
+           The symbol is rendered once to a sprite, that is composed
+           into the image for each point. The image is divided into
+           horizontal bands, that are composed in parallel by
+           renderThreadCount() threads.
+
+           This is an optimization for scatter plots with a huge amount
+           of points, where painting a pixmap for each point with
+           QPainter is the bottleneck. It has no effect, when painting
+           to a scalable paint device ( f.e. PDF or SVG ).
+
+           \sa QwtPointMapper::toImage(), ImageBuffer
+         */
+        SymbolImageBuffer = 0x40,
+
+        /*!
+           Fit the curve in scale coordinates once and cache the result,
+           so that panning and zooming do not need to run the curve fitter
+           again. This is an optimization for splines with a locality() of 0
+           ( f.e. QwtSplineCubic ), where all points have an effect on
+           each segment of the curve.
+
+           The cache is used for curve fitters in QwtCurveFitter::Path mode,
+           when both scales are linear, the curve is not filled and
+           the complete curve is painted. The fitted path is clipped
+           to the canvas, when ClipPolygons is enabled.
+
+           The cache is invalidated, when the revision of the samples
+           ( QwtSeriesData::revision() ) has changed, by dataChanged()
+           and by itemChanged(). So itemChanged() has to be called after
+           modifying the settings of the curve fitter.
+
+           \note As the fitter operates on scale coordinates the result
+                 is only the same for fitting algorithms, that are not
+                 affected by scaling the coordinates - f.e. splines using
+                 QwtSplineParametrization::ParameterX or
+                 QwtSplineParametrization::ParameterUniform.
+
+           \sa Fitted, setCurveFitter()
+         */
+        CacheFittedCurve = 0x80
     };
 
     Q_DECLARE_FLAGS( PaintAttributes, PaintAttribute )
@@ -271,6 +338,11 @@ class QWT_EXPORT QwtPlotCurve
     void setSamples( QwtSeriesData< QPointF >* );
 
     virtual int closestPoint( const QPointF& pos, double* dist = NULL ) const;
+    QVector< int > pointsInRect( const QRectF& ) const;
+
+    void setSpatialIndexEnabled( bool on );
+    bool isSpatialIndexEnabled() const;
+
     virtual int adjacentPoint( Qt::Orientation orientation, qreal value ) const;
 
     qreal interpolatedValueAt( Qt::Orientation, double ) const;
@@ -302,12 +374,20 @@ class QWT_EXPORT QwtPlotCurve
     void setCurveFitter( QwtCurveFitter* );
     QwtCurveFitter* curveFitter() const;
 
+    void setDensityColorMap( QwtColorMap* );
+    const QwtColorMap* densityColorMap() const;
+
+    void setDensityTransformation( QwtTransform* );
+    const QwtTransform* densityTransformation() const;
+
     virtual void drawSeries( QPainter*,
         const QwtScaleMap& xMap, const QwtScaleMap& yMap,
         const QRectF& canvasRect, int from, int to ) const QWT_OVERRIDE;
 
     virtual QwtGraphic legendIcon( int index, const QSizeF& ) const QWT_OVERRIDE;
 
+    virtual void itemChanged() QWT_OVERRIDE;
+
   protected:
 
     void init();
@@ -343,7 +423,13 @@ class QWT_EXPORT QwtPlotCurve
     void closePolyline( QPainter*,
         const QwtScaleMap&, const QwtScaleMap&, QPolygonF& ) const;
 
+    virtual void dataChanged() QWT_OVERRIDE;
+
   private:
+    void drawSymbolImage( QPainter*, const QwtSymbol&,
+        const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+        const QRectF& clipRect, int from, int to ) const;
+
     class PrivateData;
     PrivateData* m_data;
 };
@@ -336,7 +336,7 @@ bool QwtPlotItem::testRenderHint( RenderHint hint ) const
 
 /*!
    On multi core systems rendering of certain plot item
-   ( f.e QwtPlotRasterItem ) can be done in parallel in
+   ( f.e QwtPlotRasterItem, QwtPlotCurve ) can be done in parallel in
    several threads.
 
    The default setting is set to 1.
@@ -8,6 +8,7 @@
  *****************************************************************************/
 
 #include "qwt_plot_rasteritem.h"
+#include "qwt_plot.h"
 #include "qwt_scale_map.h"
 #include "qwt_painter.h"
 #include "qwt_text.h"
@@ -19,20 +20,293 @@
 #include <qthread.h>
 #include <qfuture.h>
 #include <qtconcurrentrun.h>
+#include <qhash.h>
+#include <qatomic.h>
+#include <qsharedpointer.h>
+#include <qcoreapplication.h>
+#include <qevent.h>
 
 #include <limits>
+#include <cstring>
+
+#if !defined( QT_NO_QFUTURE )
+#define QWT_USE_THREADS 1
+#endif
+
+namespace
+{
+    // width and height of a tile in pixels
+    const int qwtTileSize = 256;
+
+    /*
+        The pixels of a resolution form a grid, that is aligned
+        to the scale coordinates of its first pixel. The grid does not
+        change when panning, so tiles can be reused.
+     */
+    class TileLevel
+    {
+      public:
+        int id;
+
+        // scale coordinates of the pixel ( 0, 0 )
+        double x0;
+        double y0;
+
+        // scale coordinates per pixel, negative for inverted maps
+        double dx;
+        double dy;
+    };
+
+    class TileKey
+    {
+      public:
+        TileKey()
+            : level( -1 )
+            , column( 0 )
+            , row( 0 )
+        {
+        }
+
+        TileKey( int levelId, qint64 column, qint64 row )
+            : level( levelId )
+            , column( column )
+            , row( row )
+        {
+        }
+
+        inline bool operator==( const TileKey& other ) const
+        {
+            return ( level == other.level ) &&
+                ( column == other.column ) && ( row == other.row );
+        }
+
+        int level;
+        qint64 column;
+        qint64 row;
+    };
+
+    inline uint qHash( const TileKey& key )
+    {
+        const quint64 h = quint64( key.column ) * Q_UINT64_C( 0x9e3779b97f4a7c15 )
+            ^ ( quint64( key.row ) + ( quint64( key.level ) << 48 ) );
+
+        return uint( h ^ ( h >> 32 ) );
+    }
+
+    class Tile
+    {
+      public:
+        Tile()
+            : usage( 0 )
+        {
+        }
+
+        QImage image;
+        quint64 usage;
+    };
+
+#if QWT_USE_THREADS
+
+    /*
+        Lives in the GUI thread and replots, when tiles have been
+        rendered in the worker threads. Notifications, that arrive before
+        the replot has been done, are compressed.
+     */
+    class TileNotifier : public QObject
+    {
+      public:
+        explicit TileNotifier( const QwtPlotRasterItem* item )
+            : m_item( item )
+        {
+        }
+
+        // called from the worker threads
+        void notify()
+        {
+            if ( m_posted.testAndSetOrdered( 0, 1 ) )
+                QCoreApplication::postEvent( this, new QEvent( QEvent::User ) );
+        }
+
+      protected:
+        virtual void customEvent( QEvent* ) QWT_OVERRIDE
+        {
+            m_posted.fetchAndStoreOrdered( 0 );
+
+            QwtPlot* plot = m_item->plot();
+            if ( plot )
+                plot->replot();
+        }
+
+      private:
+        const QwtPlotRasterItem* m_item;
+        QAtomicInt m_posted;
+    };
+
+    // shared between the GUI and a worker thread
+    class TileResult
+    {
+      public:
+        TileResult()
+            : canceled( 0 )
+            , finished( 0 )
+        {
+        }
+
+        QAtomicInt canceled;
+        QAtomicInt finished;
+
+        QImage image;
+    };
+
+    // limitation of QtConcurrent::run()
+    class TileJob
+    {
+      public:
+        const QwtPlotRasterItem* item;
+
+        QwtScaleMap xMap;
+        QwtScaleMap yMap;
+        QRectF area;
+
+        QSharedPointer< TileResult > result;
+        TileNotifier* notifier;
+    };
+
+    class PendingTile
+    {
+      public:
+        PendingTile()
+            : usage( 0 )
+        {
+        }
+
+        QFuture< void > future;
+        QSharedPointer< TileResult > result;
+        quint64 usage;
+    };
+
+#endif
+}
+
+static inline qint64 qwtFloorDiv( qint64 value, int divisor )
+{
+    if ( value >= 0 )
+        return value / divisor;
+
+    return -( ( -value + divisor - 1 ) / divisor );
+}
+
+static inline bool qwtFuzzyEqual( double value1, double value2 )
+{
+    return qAbs( value1 - value2 ) <= 1e-6 * qAbs( value1 );
+}
+
+static inline qint64 qwtImageBytes( const QImage& image )
+{
+    return qint64( image.bytesPerLine() ) * image.height();
+}
+
+static void qwtTileMaps( const TileLevel& level, qint64 column, qint64 row,
+    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+    QwtScaleMap& xxMap, QwtScaleMap& yyMap, QRectF& area )
+{
+    const double x1 = level.x0 + column * qwtTileSize * level.dx;
+    const double x2 = x1 + qwtTileSize * level.dx;
+    const double y1 = level.y0 + row * qwtTileSize * level.dy;
+    const double y2 = y1 + qwtTileSize * level.dy;
+
+    xxMap = xMap;
+    xxMap.setPaintInterval( 0.0, qwtTileSize );
+    xxMap.setScaleInterval( x1, x2 );
+
+    yyMap = yMap;
+    yyMap.setPaintInterval( 0.0, qwtTileSize );
+    yyMap.setScaleInterval( y1, y2 );
+
+    area = QRectF( QPointF( x1, y1 ), QPointF( x2, y2 ) ).normalized();
+}
+
+/*
+    The pixels of the grid of a level, that contain the centers
+    of the pixels of the grid of another level
+ */
+static void qwtGridPixels( double origin1, double step1, qint64 from,
+    double origin2, double step2, QVector< qint64 >& pixels )
+{
+    for ( int i = 0; i < pixels.size(); i++ )
+    {
+        const double value = origin1 + ( from + i + 0.5 ) * step1;
+        pixels[i] = qint64( std::floor( ( value - origin2 ) / step2 ) );
+    }
+}
+
+// nearest neighbour resampling of the tile into an ARGB32 image
+static void qwtResampleTile( const QImage& tile, qint64 tileX, qint64 tileY,
+    const QVector< qint64 >& px, const QVector< qint64 >& py,
+    QImage& image, const QPoint& pos )
+{
+    const QVector< QRgb > colorTable = tile.colorTable();
+
+    for ( int i = 0; i < py.size(); i++ )
+    {
+        const qint64 y = py[i] - tileY;
+        if ( y < 0 || y >= tile.height() )
+            continue;
+
+        QRgb* line = reinterpret_cast< QRgb* >(
+            image.scanLine( pos.y() + i ) ) + pos.x();
+
+        const uchar* tileLine = tile.constScanLine( int( y ) );
+
+        for ( int j = 0; j < px.size(); j++ )
+        {
+            const qint64 x = px[j] - tileX;
+            if ( x < 0 || x >= tile.width() )
+                continue;
+
+            if ( tile.depth() == 8 )
+            {
+                const int index = tileLine[x];
+                line[j] = ( index < colorTable.size() ) ? colorTable[index] : 0u;
+            }
+            else
+            {
+                line[j] = reinterpret_cast< const QRgb* >( tileLine )[x];
+            }
+        }
+    }
+}
 
 class QwtPlotRasterItem::PrivateData
 {
   public:
     PrivateData()
         : alpha( -1 )
+        , threadSafeRendering( false )
         , paintAttributes( QwtPlotRasterItem::PaintInDeviceResolution )
     {
         cache.policy = QwtPlotRasterItem::NoCache;
+
+        tileCache.limit = 64 * 1024;
+        tileCache.bytes = 0;
+        tileCache.frame = 0;
+        tileCache.levelId = 0;
+
+#if QWT_USE_THREADS
+        notifier = NULL;
+#endif
+    }
+
+    ~PrivateData()
+    {
+#if QWT_USE_THREADS
+        tileCache.waitForJobs();
+        delete notifier;
+#endif
     }
 
     int alpha;
+    bool threadSafeRendering;
 
     QwtPlotRasterItem::PaintAttributes paintAttributes;
 
@@ -43,6 +317,273 @@ class QwtPlotRasterItem::PrivateData
         QSizeF size;
         QImage image;
     } cache;
+
+    struct TileCache
+    {
+        const TileLevel& level( double x1, double y1, double dx, double dy )
+        {
+            for ( int i = 0; i < levels.size(); i++ )
+            {
+                const TileLevel& l = levels[i];
+                if ( qwtFuzzyEqual( l.dx, dx ) && qwtFuzzyEqual( l.dy, dy ) )
+                    return l;
+            }
+
+            TileLevel l;
+            l.id = levelId++;
+            l.x0 = x1;
+            l.y0 = y1;
+            l.dx = dx;
+            l.dy = dy;
+
+            levels += l;
+            return levels.last();
+        }
+
+        void trim( int currentLevel )
+        {
+            const qint64 maxBytes = qint64( limit ) * 1024;
+
+            while ( bytes > maxBytes )
+            {
+                // tiles of the current frame are never removed
+
+                QHash< TileKey, Tile >::iterator lru = tiles.end();
+                for ( QHash< TileKey, Tile >::iterator it = tiles.begin();
+                    it != tiles.end(); ++it )
+                {
+                    if ( it.value().usage < frame &&
+                        ( lru == tiles.end() || it.value().usage < lru.value().usage ) )
+                    {
+                        lru = it;
+                    }
+                }
+
+                if ( lru == tiles.end() )
+                    break;
+
+                bytes -= qwtImageBytes( lru.value().image );
+                tiles.erase( lru );
+            }
+
+            for ( int i = levels.size() - 1; i >= 0; i-- )
+            {
+                if ( levels[i].id == currentLevel )
+                    continue;
+
+                bool isUsed = false;
+                for ( QHash< TileKey, Tile >::const_iterator it = tiles.constBegin();
+                    !isUsed && it != tiles.constEnd(); ++it )
+                {
+                    isUsed = ( it.key().level == levels[i].id );
+                }
+
+                if ( !isUsed )
+                    levels.remove( i );
+            }
+        }
+
+        /*
+            Fill a part of the image, where the tile is not available yet,
+            from the cached tiles of other resolutions. The levels closest
+            to the resolution of the image are painted last.
+         */
+        void fillFromLevels( const TileLevel& level, qint64 gx, qint64 gy,
+            const QRect& imageRect, QImage& image )
+        {
+            QVector< double > ratios;
+            QVector< int > candidates;
+
+            for ( int i = 0; i < levels.size(); i++ )
+            {
+                const TileLevel& l = levels[i];
+                if ( l.id == level.id )
+                    continue;
+
+                const double ratio = qAbs( l.dx / level.dx );
+
+                // finer levels would need too many tiles
+                if ( ratio >= 0.25 )
+                {
+                    const double distance = qAbs( std::log( ratio ) );
+
+                    int pos = 0;
+                    while ( pos < ratios.size() && ratios[pos] > distance )
+                        pos++;
+
+                    ratios.insert( pos, distance );
+                    candidates.insert( pos, i );
+                }
+            }
+
+            QVector< qint64 > px( imageRect.width() );
+            QVector< qint64 > py( imageRect.height() );
+
+            for ( int i = 0; i < candidates.size(); i++ )
+            {
+                const TileLevel& l = levels[ candidates[i] ];
+
+                qwtGridPixels( level.x0, level.dx, gx + imageRect.left(), l.x0, l.dx, px );
+                qwtGridPixels( level.y0, level.dy, gy + imageRect.top(), l.y0, l.dy, py );
+
+                const qint64 column1 = qwtFloorDiv( qMin( px.first(), px.last() ), qwtTileSize );
+                const qint64 column2 = qwtFloorDiv( qMax( px.first(), px.last() ), qwtTileSize );
+                const qint64 row1 = qwtFloorDiv( qMin( py.first(), py.last() ), qwtTileSize );
+                const qint64 row2 = qwtFloorDiv( qMax( py.first(), py.last() ), qwtTileSize );
+
+                if ( ( column2 - column1 + 1 ) * ( row2 - row1 + 1 ) > 16 )
+                    continue;
+
+                for ( qint64 row = row1; row <= row2; row++ )
+                {
+                    for ( qint64 column = column1; column <= column2; column++ )
+                    {
+                        QHash< TileKey, Tile >::iterator it =
+                            tiles.find( TileKey( l.id, column, row ) );
+
+                        if ( it == tiles.end() || it.value().image.isNull() )
+                            continue;
+
+                        // keep the tile as long as it is needed
+                        it.value().usage = frame;
+
+                        qwtResampleTile( it.value().image,
+                            column * qwtTileSize, row * qwtTileSize,
+                            px, py, image, imageRect.topLeft() );
+                    }
+                }
+            }
+        }
+
+#if QWT_USE_THREADS
+        void dispatch( const TileKey& key, const TileJob& job )
+        {
+            PendingTile& tile = pending[key];
+            if ( tile.result.isNull() )
+            {
+                TileJob j = job;
+                j.result = tile.result =
+                    QSharedPointer< TileResult >( new TileResult() );
+
+                tile.future = QtConcurrent::run(
+                    &QwtPlotRasterItem::PrivateData::renderTile, j );
+            }
+
+            tile.usage = frame;
+        }
+
+        void takeFinished()
+        {
+            for ( QHash< TileKey, PendingTile >::iterator it = pending.begin();
+                it != pending.end(); )
+            {
+                const QSharedPointer< TileResult >& result = it.value().result;
+
+                if ( result->finished.fetchAndAddAcquire( 0 ) == 0 )
+                {
+                    ++it;
+                    continue;
+                }
+
+                bool hasLevel = false;
+                for ( int i = 0; !hasLevel && i < levels.size(); i++ )
+                    hasLevel = ( levels[i].id == it.key().level );
+
+                if ( hasLevel )
+                {
+                    /*
+                        A null image is stored as well, so that the tile
+                        is not dispatched again and again
+                     */
+                    Tile& tile = tiles[ it.key() ];
+                    tile.image = result->image;
+                    tile.usage = frame;
+
+                    bytes += qwtImageBytes( tile.image );
+                }
+
+                it = pending.erase( it );
+            }
+
+            for ( int i = canceled.size() - 1; i >= 0; i-- )
+            {
+                if ( canceled[i].isFinished() )
+                    canceled.removeAt( i );
+            }
+        }
+
+        // cancel the jobs for tiles, that are not needed anymore
+        void cancel( quint64 usage )
+        {
+            for ( QHash< TileKey, PendingTile >::iterator it = pending.begin();
+                it != pending.end(); )
+            {
+                if ( it.value().usage < usage )
+                {
+                    it.value().result->canceled.fetchAndStoreOrdered( 1 );
+                    canceled += it.value().future;
+
+                    it = pending.erase( it );
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        void waitForJobs()
+        {
+            cancel( std::numeric_limits< quint64 >::max() );
+
+            for ( int i = 0; i < canceled.size(); i++ )
+                canceled[i].waitForFinished();
+
+            canceled.clear();
+        }
+#endif
+
+        void clear()
+        {
+#if QWT_USE_THREADS
+            waitForJobs();
+#endif
+            tiles.clear();
+            levels.clear();
+            bytes = 0;
+        }
+
+        int limit; // kilobytes
+        qint64 bytes;
+        quint64 frame;
+        int levelId;
+
+        QVector< TileLevel > levels;
+        QHash< TileKey, Tile > tiles;
+
+#if QWT_USE_THREADS
+        QHash< TileKey, PendingTile > pending;
+        QList< QFuture< void > > canceled;
+#endif
+    } tileCache;
+
+#if QWT_USE_THREADS
+    static void renderTile( const TileJob& job )
+    {
+        TileResult* result = job.result.data();
+
+        if ( result->canceled.fetchAndAddAcquire( 0 ) )
+            return;
+
+        result->image = job.item->renderImage( job.xMap, job.yMap,
+            job.area, QSize( qwtTileSize, qwtTileSize ) );
+
+        result->finished.fetchAndStoreRelease( 1 );
+        job.notifier->notify();
+    }
+
+    TileNotifier* notifier;
+#endif
 };
 
 
@@ -365,7 +906,7 @@ static bool qwtUseCache( QwtPlotRasterItem::CachePolicy policy,
 {
     bool doCache = false;
 
-    if ( policy == QwtPlotRasterItem::PaintCache )
+    if ( policy != QwtPlotRasterItem::NoCache )
     {
         // Caching doesn't make sense, when the item is
         // not painted to screen
@@ -388,13 +929,22 @@ static bool qwtUseCache( QwtPlotRasterItem::CachePolicy policy,
     return doCache;
 }
 
+static inline QRgb qwtPremultiplied( QRgb rgb, int alpha )
+{
+    // pixels with an alpha value of 0 are invalid and stay transparent
+    if ( qAlpha( rgb ) == 0 )
+        return 0u;
+
+    const int r = ( qRed( rgb ) * alpha + 127 ) / 255;
+    const int g = ( qGreen( rgb ) * alpha + 127 ) / 255;
+    const int b = ( qBlue( rgb ) * alpha + 127 ) / 255;
+
+    return qRgba( r, g, b, alpha );
+}
+
 static void qwtToRgba( const QImage* from, QImage* to,
     const QRect& tile, int alpha )
 {
-    const QRgb mask1 = qRgba( 0, 0, 0, alpha );
-    const QRgb mask2 = qRgba( 255, 255, 255, 0 );
-    const QRgb mask3 = qRgba( 0, 0, 0, 255 );
-
     const int y0 = tile.top();
     const int y1 = tile.bottom();
     const int x0 = tile.left();
@@ -402,31 +952,117 @@ static void qwtToRgba( const QImage* from, QImage* to,
 
     if ( from->depth() == 8 )
     {
+        const QVector< QRgb > colorTable = from->colorTable();
+
+        // the color table has to be converted only once
+        QRgb rgbTable[256];
+        for ( int i = 0; i < 256; i++ )
+        {
+            rgbTable[i] = ( i < colorTable.size() )
+                ? qwtPremultiplied( colorTable[i], alpha ) : 0u;
+        }
+
         for ( int y = y0; y <= y1; y++ )
         {
-            QRgb* alphaLine = reinterpret_cast< QRgb* >( to->scanLine( y ) );
-            const unsigned char* line = from->scanLine( y );
+            QRgb* alphaLine = reinterpret_cast< QRgb* >( to->scanLine( y ) ) + x0;
+            const unsigned char* line = from->scanLine( y ) + x0;
 
             for ( int x = x0; x <= x1; x++ )
-                *alphaLine++ = ( from->color( *line++ ) & mask2 ) | mask1;
+                *alphaLine++ = rgbTable[ *line++ ];
         }
     }
     else if ( from->depth() == 32 )
     {
         for ( int y = y0; y <= y1; y++ )
         {
-            QRgb* alphaLine = reinterpret_cast< QRgb* >( to->scanLine( y ) );
-            const QRgb* line = reinterpret_cast< const QRgb* >( from->scanLine( y ) );
+            QRgb* alphaLine = reinterpret_cast< QRgb* >( to->scanLine( y ) ) + x0;
+            const QRgb* line = reinterpret_cast< const QRgb* >( from->scanLine( y ) ) + x0;
 
             for ( int x = x0; x <= x1; x++ )
+                *alphaLine++ = qwtPremultiplied( *line++, alpha );
+        }
+    }
+}
+
+static QImage qwtAlphaImage( const QImage& image, int alpha, uint numThreads )
+{
+    QImage alphaImage( image.size(), QImage::Format_ARGB32_Premultiplied );
+
+#if !defined( QT_NO_QFUTURE )
+    if ( numThreads <= 0 )
+        numThreads = QThread::idealThreadCount();
+
+    if ( numThreads <= 0 )
+        numThreads = 1;
+
+    const int numRows = image.height() / numThreads;
+
+    QVector< QFuture< void > > futures;
+    futures.reserve( numThreads - 1 );
+
+    for ( uint i = 0; i < numThreads; i++ )
+    {
+        QRect tile( 0, i * numRows, image.width(), numRows );
+        if ( i == numThreads - 1 )
+        {
+            tile.setHeight( image.height() - i * numRows );
+            qwtToRgba( &image, &alphaImage, tile, alpha );
+        }
+        else
+        {
+            futures += QtConcurrent::run(
+                &qwtToRgba, &image, &alphaImage, tile, alpha );
+        }
+    }
+    for ( int i = 0; i < futures.size(); i++ )
+        futures[i].waitForFinished();
+#else
+    Q_UNUSED( numThreads );
+
+    const QRect tile( 0, 0, image.width(), image.height() );
+    qwtToRgba( &image, &alphaImage, tile, alpha );
+#endif
+
+    return alphaImage;
+}
+
+static void qwtCopyTile( const QImage& tile, const QRect& tileRect,
+    QImage& image, const QRect& imageRect )
+{
+    if ( tile.depth() == 8 && image.depth() == 32 )
+    {
+        const QVector< QRgb > colorTable = tile.colorTable();
+
+        for ( int i = 0; i < tileRect.height(); i++ )
+        {
+            const uchar* from = tile.scanLine( tileRect.top() + i )
+                + tileRect.left();
+
+            QRgb* to = reinterpret_cast< QRgb* >(
+                image.scanLine( imageRect.top() + i ) ) + imageRect.left();
+
+            for ( int j = 0; j < tileRect.width(); j++ )
             {
-                const QRgb rgb = *line++;
-                if ( rgb & mask3 ) // alpha != 0
-                    *alphaLine++ = ( rgb & mask2 ) | mask1;
-                else
-                    *alphaLine++ = rgb;
+                const int index = from[j];
+                to[j] = ( index < colorTable.size() ) ? colorTable[index] : 0u;
             }
         }
+
+        return;
+    }
+
+    const int bytesPerPixel = image.depth() / 8;
+    const size_t numBytes = size_t( tileRect.width() ) * bytesPerPixel;
+
+    for ( int i = 0; i < tileRect.height(); i++ )
+    {
+        const uchar* from = tile.scanLine( tileRect.top() + i )
+            + tileRect.left() * bytesPerPixel;
+
+        uchar* to = image.scanLine( imageRect.top() + i )
+            + imageRect.left() * bytesPerPixel;
+
+        std::memcpy( to, from, numBytes );
     }
 }
 
@@ -532,6 +1168,45 @@ int QwtPlotRasterItem::alpha() const
     return m_data->alpha;
 }
 
+/*!
+   \brief Declare renderImage() as being thread-safe
+
+   AsynchronousRendering calls renderImage() from the worker threads
+   of QThreadPool::globalInstance(), while the item might be modified in
+   the GUI thread. So it is ignored unless it has been confirmed, that
+   renderImage() of the item can be called concurrently.
+
+   Classes might enable thread-safe rendering in their constructor,
+   or an application enables it for an item, when it knows, that the
+   implementations of renderImage() and of the data are thread-safe.
+   Then invalidateCache(), that cancels and waits for the running jobs,
+   has to be called in the destructor and before modifying anything,
+   that is used by renderImage().
+
+   The default setting is false.
+
+   \param on On/Off
+   \sa hasThreadSafeRendering(), AsynchronousRendering
+ */
+void QwtPlotRasterItem::setThreadSafeRendering( bool on )
+{
+    if ( on != m_data->threadSafeRendering )
+    {
+        m_data->threadSafeRendering = on;
+        if ( !on )
+            invalidateCache();
+    }
+}
+
+/*!
+   \return True, when renderImage() has been declared as being thread-safe
+   \sa setThreadSafeRendering(), AsynchronousRendering
+ */
+bool QwtPlotRasterItem::hasThreadSafeRendering() const
+{
+    return m_data->threadSafeRendering;
+}
+
 /*!
    Change the cache policy
 
@@ -561,15 +1236,48 @@ QwtPlotRasterItem::CachePolicy QwtPlotRasterItem::cachePolicy() const
     return m_data->cache.policy;
 }
 
+/*!
+   Set the maximum amount of memory for the tiles of the TileCache
+
+   The default limit is 64MB.
+
+   \param kiloBytes Limit in kilobytes
+   \sa tileCacheLimit(), setCachePolicy()
+ */
+void QwtPlotRasterItem::setTileCacheLimit( int kiloBytes )
+{
+    kiloBytes = qMax( kiloBytes, 0 );
+    if ( kiloBytes != m_data->tileCache.limit )
+    {
+        m_data->tileCache.limit = kiloBytes;
+        m_data->tileCache.trim( -1 );
+    }
+}
+
+/*!
+   \return Maximum amount of memory for the tiles of the TileCache in kilobytes
+   \sa setTileCacheLimit()
+ */
+int QwtPlotRasterItem::tileCacheLimit() const
+{
+    return m_data->tileCache.limit;
+}
+
 /*!
    Invalidate the paint cache
-   \sa setCachePolicy()
+
+   Jobs for rendering tiles asynchronously are cancelled and
+   the jobs, that are already running, are waited for.
+
+   \sa setCachePolicy(), AsynchronousRendering
  */
 void QwtPlotRasterItem::invalidateCache()
 {
     m_data->cache.image = QImage();
     m_data->cache.area = QRect();
     m_data->cache.size = QSize();
+
+    m_data->tileCache.clear();
 }
 
 /*!
@@ -700,8 +1408,16 @@ void QwtPlotRasterItem::draw( QPainter* painter,
         imageSize *= pixelRatio;
 #endif
 
-        image = compose(xxMap, yyMap,
-            area, paintRect, imageSize.toSize(), doCache);
+        if ( doCache && m_data->cache.policy == TileCache &&
+            xxMap.transformation() == NULL && yyMap.transformation() == NULL )
+        {
+            image = composeTiles( xxMap, yyMap, paintRect, imageSize.toSize() );
+        }
+        else
+        {
+            image = compose(xxMap, yyMap,
+                area, paintRect, imageSize.toSize(), doCache);
+        }
 
         if ( image.isNull() )
             return;
@@ -845,6 +1561,8 @@ QImage QwtPlotRasterItem::compose(
     if ( imageArea.isEmpty() || paintRect.isEmpty() || imageSize.isEmpty() )
         return image;
 
+    bool isAlphaApplied = false;
+
     if ( doCache )
     {
         if ( !m_data->cache.image.isNull()
@@ -873,6 +1591,14 @@ QImage QwtPlotRasterItem::compose(
 
         image = renderImage( xxMap, yyMap, imageArea, imageSize );
 
+        /*
+            Cached images have to be independent of the alpha value.
+            Otherwise renderImage() might have applied it already,
+            what saves a pass over all pixels.
+         */
+        isAlphaApplied = ( m_data->cache.policy == NoCache )
+            && ( image.format() == QImage::Format_ARGB32_Premultiplied );
+
         if ( doCache )
         {
             m_data->cache.area = imageArea;
@@ -881,47 +1607,180 @@ QImage QwtPlotRasterItem::compose(
         }
     }
 
-    if ( m_data->alpha >= 0 && m_data->alpha < 255 )
+    if ( m_data->alpha >= 0 && m_data->alpha < 255 && !isAlphaApplied )
+        image = qwtAlphaImage( image, m_data->alpha, renderThreadCount() );
+
+    return image;
+}
+
+QImage QwtPlotRasterItem::composeTiles(
+    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+    const QRectF& paintRect, const QSize& imageSize ) const
+{
+    if ( paintRect.isEmpty() || imageSize.isEmpty() )
+        return QImage();
+
+    PrivateData::TileCache& cache = m_data->tileCache;
+
+    // scale coordinates per pixel of the image
+    const double dx = ( xMap.s2() - xMap.s1() ) / ( xMap.p2() - xMap.p1() )
+        * paintRect.width() / imageSize.width();
+    const double dy = ( yMap.s2() - yMap.s1() ) / ( yMap.p2() - yMap.p1() )
+        * paintRect.height() / imageSize.height();
+
+    const double x1 = xMap.invTransform( paintRect.left() );
+    const double y1 = yMap.invTransform( paintRect.top() );
+
+    const TileLevel level = cache.level( x1, y1, dx, dy );
+
+    // the first pixel of the image on the grid of the level
+    const qint64 gx = qRound64( ( x1 - level.x0 ) / level.dx );
+    const qint64 gy = qRound64( ( y1 - level.y0 ) / level.dy );
+
+    const qint64 column1 = qwtFloorDiv( gx, qwtTileSize );
+    const qint64 column2 = qwtFloorDiv( gx + imageSize.width() - 1, qwtTileSize );
+    const qint64 row1 = qwtFloorDiv( gy, qwtTileSize );
+    const qint64 row2 = qwtFloorDiv( gy + imageSize.height() - 1, qwtTileSize );
+
+    cache.frame++;
+
+#if QWT_USE_THREADS
+    const bool async = m_data->threadSafeRendering
+        && testPaintAttribute( AsynchronousRendering );
+
+    if ( async && m_data->notifier == NULL )
+        m_data->notifier = new TileNotifier( this );
+
+    cache.takeFinished();
+#endif
+
+    /*
+        Find the tiles of the image, rendering or dispatching
+        those, that are not in the cache
+     */
+
+    QImage formatTile;
+    bool hasHoles = false;
+
+    for ( qint64 row = row1; row <= row2; row++ )
     {
-        QImage alphaImage( image.size(), QImage::Format_ARGB32 );
+        for ( qint64 column = column1; column <= column2; column++ )
+        {
+            const TileKey key( level.id, column, row );
 
-#if !defined( QT_NO_QFUTURE )
-        uint numThreads = renderThreadCount();
+            QHash< TileKey, Tile >::iterator it = cache.tiles.find( key );
+            if ( it == cache.tiles.end() )
+            {
+                QwtScaleMap xxMap, yyMap;
+                QRectF area;
+
+                qwtTileMaps( level, column, row, xMap, yMap, xxMap, yyMap, area );
+
+#if QWT_USE_THREADS
+                if ( async )
+                {
+                    TileJob job;
+                    job.item = this;
+                    job.xMap = xxMap;
+                    job.yMap = yyMap;
+                    job.area = area;
+                    job.notifier = m_data->notifier;
 
-        if ( numThreads <= 0 )
-            numThreads = QThread::idealThreadCount();
+                    cache.dispatch( key, job );
 
-        if ( numThreads <= 0 )
-            numThreads = 1;
+                    hasHoles = true;
+                    continue;
+                }
+#endif
+
+                const QImage image = renderImage( xxMap, yyMap,
+                    area, QSize( qwtTileSize, qwtTileSize ) );
+
+                if ( image.isNull() )
+                    return QImage();
+
+                it = cache.tiles.insert( key, Tile() );
+                it.value().image = image;
+
+                cache.bytes += qwtImageBytes( image );
+            }
+
+            Tile& tile = it.value();
+            tile.usage = cache.frame;
 
-        const int numRows = image.height() / numThreads;
+            if ( tile.image.isNull() )
+                hasHoles = true;
+            else if ( formatTile.isNull() )
+                formatTile = tile.image;
+        }
+    }
 
-        QVector< QFuture< void > > futures;
-        futures.reserve( numThreads - 1 );
+#if QWT_USE_THREADS
+    cache.cancel( cache.frame );
+#endif
 
-        for ( uint i = 0; i < numThreads; i++ )
+    QImage image;
+
+    if ( hasHoles )
+    {
+        // the missing parts of the image are transparent
+
+        image = QImage( imageSize, QImage::Format_ARGB32 );
+        image.fill( 0 );
+    }
+    else
+    {
+        image = QImage( imageSize, formatTile.format() );
+        if ( image.format() == QImage::Format_Indexed8 )
+            image.setColorTable( formatTile.colorTable() );
+    }
+
+    for ( qint64 row = row1; row <= row2; row++ )
+    {
+        for ( qint64 column = column1; column <= column2; column++ )
         {
-            QRect tile( 0, i * numRows, image.width(), numRows );
-            if ( i == numThreads - 1 )
+            // the intersection of tile and image on the grid
+            const qint64 left = qMax( column * qwtTileSize, gx );
+            const qint64 right = qMin( ( column + 1 ) * qwtTileSize, gx + imageSize.width() );
+            const qint64 top = qMax( row * qwtTileSize, gy );
+            const qint64 bottom = qMin( ( row + 1 ) * qwtTileSize, gy + imageSize.height() );
+
+            const QSize size( int( right - left ), int( bottom - top ) );
+
+            const QRect imageRect( QPoint( int( left - gx ), int( top - gy ) ), size );
+
+            const TileKey key( level.id, column, row );
+
+            QHash< TileKey, Tile >::const_iterator it = cache.tiles.constFind( key );
+            if ( it == cache.tiles.constEnd() )
             {
-                tile.setHeight( image.height() - i * numRows );
-                qwtToRgba( &image, &alphaImage, tile, m_data->alpha );
+                // the tile is being rendered: showing a preview meanwhile
+                cache.fillFromLevels( level, gx, gy, imageRect, image );
+                continue;
             }
-            else
+
+            const QImage& tileImage = it.value().image;
+            if ( tileImage.isNull() )
+                continue;
+
+            if ( tileImage.format() != image.format() &&
+                !( tileImage.depth() == 8 && image.depth() == 32 ) )
             {
-                futures += QtConcurrent::run(
-                    &qwtToRgba, &image, &alphaImage, tile, m_data->alpha );
+                continue;
             }
+
+            const QRect tileRect( QPoint( int( left - column * qwtTileSize ),
+                int( top - row * qwtTileSize ) ), size );
+
+            qwtCopyTile( tileImage, tileRect, image, imageRect );
         }
-        for ( int i = 0; i < futures.size(); i++ )
-            futures[i].waitForFinished();
-#else
-        const QRect tile( 0, 0, image.width(), image.height() );
-        qwtToRgba( &image, &alphaImage, tile, m_data->alpha );
-#endif
-        image = alphaImage;
     }
 
+    cache.trim( level.id );
+
+    if ( m_data->alpha >= 0 && m_data->alpha < 255 )
+        image = qwtAlphaImage( image, m_data->alpha, renderThreadCount() );
+
     return image;
 }
 
@@ -29,7 +29,9 @@ class QwtInterval;
    Using setAlpha() raster items can be stacked easily.
 
    QwtPlotRasterItem is only implemented for images of the following formats:
-   QImage::Format_Indexed8, QImage::Format_ARGB32.
+   QImage::Format_Indexed8, QImage::Format_ARGB32 and
+   QImage::Format_ARGB32_Premultiplied for images, where renderImage()
+   has applied the alpha value.
 
    \sa QwtPlotSpectrogram
  */
@@ -56,7 +58,29 @@ class QWT_EXPORT QwtPlotRasterItem : public QwtPlotItem
            of hide/show operations or manipulations of the alpha value.
            All other situations are handled by the canvas backing store.
          */
-        PaintCache
+        PaintCache,
+
+        /*!
+           The image is composed from tiles of 256x256 pixels, that are
+           rendered and cached for the resolution and position of the tile.
+
+           When panning only the tiles, that become visible, need to be
+           rendered. As the tiles of several resolutions are kept in the
+           cache, zooming back to a previous resolution is fast as well.
+
+           The least recently used tiles are discarded, when the memory of
+           the cache exceeds tileCacheLimit().
+
+           TileCache is used for linear scales and when painting in
+           paint device resolution only. Otherwise it falls back to PaintCache.
+
+           \note As the tiles are aligned to the pixels of a grid,
+                 that does not change when panning, the image might be shifted
+                 by up to half of a pixel.
+
+           \sa setTileCacheLimit()
+         */
+        TileCache
     };
 
     /*!
@@ -77,7 +101,30 @@ class QWT_EXPORT QwtPlotRasterItem : public QwtPlotItem
            depends on the implementation of the specific QPaintEngine.
          */
 
-        PaintInDeviceResolution = 1
+        PaintInDeviceResolution = 1,
+
+        /*!
+           Tiles of the TileCache, that are not in the cache, are rendered
+           in the worker threads of QThreadPool::globalInstance(), so that
+           draw() never waits for renderImage().
+
+           Until a tile is available its area is filled from the cached
+           tiles of other resolutions - f.e. the tiles of the previous
+           zoom level - or left transparent. When the tiles have been rendered
+           the plot gets replotted. Jobs for tiles, that are not visible
+           anymore after panning or zooming, are cancelled.
+
+           \note Has only an effect in combination with TileCache and
+                 for items, that have been declared as being thread-safe
+                 by setThreadSafeRendering().
+
+           \warning Anything, that is used by renderImage() - f.e. the
+                    data of a QwtPlotSpectrogram - must not be modified
+                    while jobs are running. invalidateCache() cancels
+                    the pending jobs and waits for the running ones and
+                    has to be called before modifying the data in place.
+         */
+        AsynchronousRendering = 2
     };
 
     Q_DECLARE_FLAGS( PaintAttributes, PaintAttribute )
@@ -95,8 +142,14 @@ class QWT_EXPORT QwtPlotRasterItem : public QwtPlotItem
     void setCachePolicy( CachePolicy );
     CachePolicy cachePolicy() const;
 
+    void setTileCacheLimit( int kiloBytes );
+    int tileCacheLimit() const;
+
     void invalidateCache();
 
+    void setThreadSafeRendering( bool on );
+    bool hasThreadSafeRendering() const;
+
     virtual void draw( QPainter*,
         const QwtScaleMap& xMap, const QwtScaleMap& yMap,
         const QRectF& canvasRect ) const QWT_OVERRIDE;
@@ -122,6 +175,13 @@ class QWT_EXPORT QwtPlotRasterItem : public QwtPlotItem
        \param imageSize Requested size of the image
 
        \return Rendered image
+
+       \note When the cache policy is NoCache, an implementation might
+             apply alpha() to the colors and return an image of
+             QImage::Format_ARGB32_Premultiplied. Otherwise the
+             alpha value is applied to the returned image afterwards.
+
+       \sa setAlpha()
      */
     virtual QImage renderImage( const QwtScaleMap& xMap,
         const QwtScaleMap& yMap, const QRectF& area,
@@ -141,6 +201,9 @@ class QWT_EXPORT QwtPlotRasterItem : public QwtPlotItem
         const QRectF& imageArea, const QRectF& paintRect,
         const QSize& imageSize, bool doCache) const;
 
+    QImage composeTiles( const QwtScaleMap&, const QwtScaleMap&,
+        const QRectF& paintRect, const QSize& imageSize ) const;
+
 
     class PrivateData;
     PrivateData* m_data;
@@ -302,8 +302,10 @@ void QwtPlotSpectroCurve::drawDots( QPainter* painter,
 
         if ( format == QwtColorMap::RGB )
         {
-            const QRgb rgb = m_data->colorMap->rgb(
-                m_data->colorRange, sample.z() );
+            const double z = sample.z();
+
+            QRgb rgb;
+            m_data->colorMap->rgbValues( m_data->colorRange, &z, 1, &rgb );
 
             painter->setPen( QPen( QColor::fromRgba( rgb ), m_data->penWidth ) );
         }
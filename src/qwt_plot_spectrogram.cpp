@@ -18,6 +18,7 @@
 #include <qpen.h>
 #include <qpainter.h>
 #include <qthread.h>
+#include <qmutex.h>
 #include <qfuture.h>
 #include <qtconcurrentrun.h>
 
@@ -45,6 +46,23 @@ static inline bool qwtIsNaN( double d )
     }
 }
 
+static inline QRgb qwtPremultiplied( QRgb rgb, int alpha )
+{
+    const int a = qAlpha( rgb );
+    if ( a == 0 )
+        return 0u;
+
+    // alpha < 0: keeping the alpha value of the color
+    if ( alpha < 0 )
+        alpha = a;
+
+    const int r = ( qRed( rgb ) * alpha + 127 ) / 255;
+    const int g = ( qGreen( rgb ) * alpha + 127 ) / 255;
+    const int b = ( qBlue( rgb ) * alpha + 127 ) / 255;
+
+    return qRgba( r, g, b, alpha );
+}
+
 class QwtPlotSpectrogram::PrivateData
 {
   public:
@@ -92,6 +110,19 @@ class QwtPlotSpectrogram::PrivateData
 
     int colorTableSize;
     QVector< QRgb > colorTable;
+
+    // initRaster() ... discardRaster() of concurrent renderImage() calls
+    QMutex rasterMutex;
+};
+
+// alpha value of a rendered image
+class QwtPlotSpectrogram::AlphaColors
+{
+  public:
+    int alpha;
+
+    // premultiplied colors of the color table
+    QVector< QRgb > colorTable;
 };
 
 /*!
@@ -119,6 +150,9 @@ QwtPlotSpectrogram::QwtPlotSpectrogram( const QString& title )
 //! Destructor
 QwtPlotSpectrogram::~QwtPlotSpectrogram()
 {
+    // waiting for tiles being rendered asynchronously
+    invalidateCache();
+
     delete m_data;
 }
 
@@ -179,6 +213,8 @@ void QwtPlotSpectrogram::setColorMap( QwtColorMap* colorMap )
     if ( colorMap == NULL )
         return;
 
+    invalidateCache();
+
     if ( colorMap != m_data->colorMap )
     {
         delete m_data->colorMap;
@@ -187,8 +223,6 @@ void QwtPlotSpectrogram::setColorMap( QwtColorMap* colorMap )
 
     m_data->updateColorTable();
 
-    invalidateCache();
-
     legendChanged();
     itemChanged();
 }
@@ -226,9 +260,10 @@ void QwtPlotSpectrogram::setColorTableSize( int numColors )
     numColors = qMax( numColors, 0 );
     if ( numColors != m_data->colorTableSize )
     {
+        invalidateCache();
+
         m_data->colorTableSize = numColors;
         m_data->updateColorTable();
-        invalidateCache();
     }
 }
 /*!
@@ -388,16 +423,22 @@ QList< double > QwtPlotSpectrogram::contourLevels() const
    Set the data to be displayed
 
    \param data Spectrogram Data
+
+   \note When the data is modified in place, invalidateCache() has to be
+         called before, so that no tile is being rendered
+         asynchronously meanwhile ( see AsynchronousRendering ).
+
    \sa data()
  */
 void QwtPlotSpectrogram::setData( QwtRasterData* data )
 {
     if ( data != m_data->data )
     {
+        invalidateCache();
+
         delete m_data->data;
         m_data->data = data;
 
-        invalidateCache();
         itemChanged();
     }
 }
@@ -472,10 +513,12 @@ QRectF QwtPlotSpectrogram::pixelHint( const QRectF& area ) const
    \param imageSize Size of the requested image
 
    \return A QImage::Format_Indexed8 or QImage::Format_ARGB32 depending
-           on the color map.
+           on the color map. When the cache policy is NoCache and an
+           alpha value is set, the alpha value is applied to the colors
+           and a QImage::Format_ARGB32_Premultiplied is returned.
 
    \sa QwtRasterData::value(), QwtColorMap::rgb(),
-       QwtColorMap::colorIndex()
+       QwtColorMap::colorIndex(), QwtPlotRasterItem::setAlpha()
  */
 QImage QwtPlotSpectrogram::renderImage(
     const QwtScaleMap& xMap, const QwtScaleMap& yMap,
@@ -491,14 +534,50 @@ QImage QwtPlotSpectrogram::renderImage(
     if ( !intensityRange.isValid() )
         return QImage();
 
-    const QImage::Format format = ( m_data->colorMap->format() == QwtColorMap::RGB )
-        ? QImage::Format_ARGB32 : QImage::Format_Indexed8;
+    /*
+        Images, that are not cached, are never painted without
+        the alpha value. Applying it to the colors saves a pass
+        over the image.
+     */
+    AlphaColors alphaColors;
+    const AlphaColors* tileColors = NULL;
+
+    const int alpha = this->alpha();
+    if ( cachePolicy() == NoCache && alpha >= 0 && alpha < 255 )
+    {
+        alphaColors.alpha = alpha;
+
+        const QVector< QRgb >& colorTable = m_data->colorTable;
+
+        alphaColors.colorTable.resize( colorTable.size() );
+        for ( int i = 0; i < colorTable.size(); i++ )
+            alphaColors.colorTable[i] = qwtPremultiplied( colorTable[i], alpha );
+
+        tileColors = &alphaColors;
+    }
+
+    QImage::Format format;
+    if ( tileColors )
+    {
+        format = QImage::Format_ARGB32_Premultiplied;
+    }
+    else
+    {
+        format = ( m_data->colorMap->format() == QwtColorMap::RGB )
+            ? QImage::Format_ARGB32 : QImage::Format_Indexed8;
+    }
 
     QImage image( imageSize, format );
 
-    if ( m_data->colorMap->format() == QwtColorMap::Indexed )
+    if ( format == QImage::Format_Indexed8 )
         image.setColorTable( m_data->colorMap->colorTable256() );
 
+    /*
+        Tiles of AsynchronousRendering are rendered concurrently,
+        but the raster data is initialized for one raster only.
+     */
+    const QMutexLocker locker( &m_data->rasterMutex );
+
     m_data->data->initRaster( area, image.size() );
 
 #if DEBUG_RENDER
@@ -526,17 +605,17 @@ QImage QwtPlotSpectrogram::renderImage(
         if ( i == numThreads - 1 )
         {
             tile.setHeight( image.height() - i * numRows );
-            renderTile( xMap, yMap, tile, &image );
+            renderColorTile( xMap, yMap, tile, tileColors, &image );
         }
         else
         {
             futures += QtConcurrent::run(
 #if QT_VERSION >= 0x060000
-                &QwtPlotSpectrogram::renderTile, this,
+                &QwtPlotSpectrogram::renderColorTile, this,
 #else
-                this, &QwtPlotSpectrogram::renderTile,
+                this, &QwtPlotSpectrogram::renderColorTile,
 #endif
-                xMap, yMap, tile, &image );
+                xMap, yMap, tile, tileColors, &image );
         }
     }
 
@@ -545,7 +624,7 @@ QImage QwtPlotSpectrogram::renderImage(
 
 #else
     const QRect tile( 0, 0, image.width(), image.height() );
-    renderTile( xMap, yMap, tile, &image );
+    renderColorTile( xMap, yMap, tile, tileColors, &image );
 #endif
 
 #if DEBUG_RENDER
@@ -568,75 +647,160 @@ QImage QwtPlotSpectrogram::renderImage(
     \param yMap Y-Scale Map
     \param tile Geometry of the tile in image coordinates
     \param image Image to be rendered
+
+    \sa QwtRasterData::values()
  */
 void QwtPlotSpectrogram::renderTile(
     const QwtScaleMap& xMap, const QwtScaleMap& yMap,
     const QRect& tile, QImage* image ) const
+{
+    renderColorTile( xMap, yMap, tile, NULL, image );
+}
+
+void QwtPlotSpectrogram::renderColorTile(
+    const QwtScaleMap& xMap, const QwtScaleMap& yMap, const QRect& tile,
+    const AlphaColors* alphaColors, QImage* image ) const
 {
     const QwtInterval range = m_data->data->interval( Qt::ZAxis );
-    if ( range.width() <= 0.0 )
+    if ( range.width() <= 0.0 || tile.isEmpty() )
         return;
 
     const bool hasGaps = !m_data->data->testAttribute( QwtRasterData::WithoutGaps );
 
-    if ( m_data->colorMap->format() == QwtColorMap::RGB )
+    /*
+        The values are requested for blocks of rows, so that
+        the raster data can do all calculations, that depend on
+        the x or y coordinate only, once per block.
+     */
+    const int numColumns = tile.width();
+    const int numBlockRows = qMax( 1, qMin( tile.height(), 16384 / numColumns ) );
+
+    QVector< double > xValues( numColumns );
+    for ( int x = 0; x < numColumns; x++ )
+        xValues[x] = xMap.invTransform( tile.left() + x );
+
+    QVector< double > yValues( numBlockRows );
+    QVector< double > values( numBlockRows * numColumns );
+
+    for ( int y0 = tile.top(); y0 <= tile.bottom(); y0 += numBlockRows )
     {
-        const int numColors = m_data->colorTable.size();
-        const QRgb* rgbTable = m_data->colorTable.constData();
-        const QwtColorMap* colorMap = m_data->colorMap;
+        const int numRows = qMin( numBlockRows, tile.bottom() - y0 + 1 );
+
+        for ( int i = 0; i < numRows; i++ )
+            yValues[i] = yMap.invTransform( y0 + i );
 
-        for ( int y = tile.top(); y <= tile.bottom(); y++ )
+        m_data->data->values( xValues.constData(), numColumns,
+            yValues.constData(), numRows, values.data() );
+
+        const double* value = values.constData();
+
+        if ( alphaColors )
         {
-            const double ty = yMap.invTransform( y );
+            const int alpha = alphaColors->alpha;
 
-            QRgb* line = reinterpret_cast< QRgb* >( image->scanLine( y ) );
-            line += tile.left();
+            const int numColors = alphaColors->colorTable.size();
+            const QRgb* rgbTable = alphaColors->colorTable.constData();
+            const QwtColorMap* colorMap = m_data->colorMap;
 
-            for ( int x = tile.left(); x <= tile.right(); x++ )
-            {
-                const double tx = xMap.invTransform( x );
+            // like in Format_Indexed8 images, where gaps have the first color
+            const QRgb gapColor = ( colorMap->format() == QwtColorMap::Indexed
+                && numColors > 0 ) ? rgbTable[0] : 0u;
 
-                const double value = m_data->data->value( tx, ty );
+            for ( int y = y0; y < y0 + numRows; y++ )
+            {
+                QRgb* line = reinterpret_cast< QRgb* >( image->scanLine( y ) );
+                line += tile.left();
 
-                if ( hasGaps && qwtIsNaN( value ) )
+                if ( numColors == 0 )
                 {
-                    *line++ = 0u;
+                    colorMap->rgbValues( range, value, numColumns, line );
+
+                    for ( int x = 0; x < numColumns; x++ )
+                    {
+                        if ( hasGaps && qwtIsNaN( value[x] ) )
+                            line[x] = 0u;
+                        else
+                            line[x] = qwtPremultiplied( line[x], alpha );
+                    }
+
+                    value += numColumns;
+                    continue;
                 }
-                else if ( numColors == 0 )
-                {
-                    *line++ = colorMap->rgb( range, value );
-                }
-                else
+
+                for ( int x = 0; x < numColumns; x++, value++ )
                 {
-                    const uint index = colorMap->colorIndex( numColors, range, value );
-                    *line++ = rgbTable[index];
+                    if ( hasGaps && qwtIsNaN( *value ) )
+                    {
+                        *line++ = gapColor;
+                    }
+                    else
+                    {
+                        const uint index = colorMap->colorIndex( numColors, range, *value );
+                        *line++ = rgbTable[index];
+                    }
                 }
             }
         }
-    }
-    else if ( m_data->colorMap->format() == QwtColorMap::Indexed )
-    {
-        for ( int y = tile.top(); y <= tile.bottom(); y++ )
+        else if ( m_data->colorMap->format() == QwtColorMap::RGB )
         {
-            const double ty = yMap.invTransform( y );
-
-            unsigned char* line = image->scanLine( y );
-            line += tile.left();
+            const int numColors = m_data->colorTable.size();
+            const QRgb* rgbTable = m_data->colorTable.constData();
+            const QwtColorMap* colorMap = m_data->colorMap;
 
-            for ( int x = tile.left(); x <= tile.right(); x++ )
+            for ( int y = y0; y < y0 + numRows; y++ )
             {
-                const double tx = xMap.invTransform( x );
+                QRgb* line = reinterpret_cast< QRgb* >( image->scanLine( y ) );
+                line += tile.left();
 
-                const double value = m_data->data->value( tx, ty );
+                if ( numColors == 0 )
+                {
+                    colorMap->rgbValues( range, value, numColumns, line );
+
+                    if ( hasGaps )
+                    {
+                        for ( int x = 0; x < numColumns; x++ )
+                        {
+                            if ( qwtIsNaN( value[x] ) )
+                                line[x] = 0u;
+                        }
+                    }
+
+                    value += numColumns;
+                    continue;
+                }
 
-                if ( hasGaps && qwtIsNaN( value ) )
+                for ( int x = 0; x < numColumns; x++, value++ )
                 {
-                    *line++ = 0;
+                    if ( hasGaps && qwtIsNaN( *value ) )
+                    {
+                        *line++ = 0u;
+                    }
+                    else
+                    {
+                        const uint index = colorMap->colorIndex( numColors, range, *value );
+                        *line++ = rgbTable[index];
+                    }
                 }
-                else
+            }
+        }
+        else if ( m_data->colorMap->format() == QwtColorMap::Indexed )
+        {
+            for ( int y = y0; y < y0 + numRows; y++ )
+            {
+                unsigned char* line = image->scanLine( y );
+                line += tile.left();
+
+                for ( int x = 0; x < numColumns; x++, value++ )
                 {
-                    const uint index = m_data->colorMap->colorIndex( 256, range, value );
-                    *line++ = static_cast< unsigned char >( index );
+                    if ( hasGaps && qwtIsNaN( *value ) )
+                    {
+                        *line++ = 0;
+                    }
+                    else
+                    {
+                        const uint index = m_data->colorMap->colorIndex( 256, range, *value );
+                        *line++ = static_cast< unsigned char >( index );
+                    }
                 }
             }
         }
@@ -683,6 +847,8 @@ QSize QwtPlotSpectrogram::contourRasterSize(
    \param raster Raster, used by the CONREC algorithm
    \return Calculated contour lines
 
+   \note The contour lines are calculated by renderThreadCount() threads.
+
    \sa contourLevels(), setConrecFlag(),
        QwtRasterData::contourLines()
  */
@@ -692,8 +858,17 @@ QwtRasterData::ContourLines QwtPlotSpectrogram::renderContourLines(
     if ( m_data->data == NULL )
         return QwtRasterData::ContourLines();
 
-    return m_data->data->contourLines( rect, raster,
-        m_data->contourLevels, m_data->conrecFlags );
+    // contourLines() initializes a raster too
+    const QMutexLocker locker( &m_data->rasterMutex );
+
+    m_data->data->setContourThreadCount( renderThreadCount() );
+
+    const QwtRasterData::ContourLines lines = m_data->data->contourLines(
+        rect, raster, m_data->contourLevels, m_data->conrecFlags );
+
+    m_data->data->setContourThreadCount( 1 );
+
+    return lines;
 }
 
 /*!
@@ -704,7 +879,11 @@ QwtRasterData::ContourLines QwtPlotSpectrogram::renderContourLines(
    \param yMap Maps y-values into pixel coordinates.
    \param contourLines Contour lines
 
-   \sa renderContourLines(), defaultContourPen(), contourPen()
+   When QwtRasterData::ConnectLines is enabled the segments are connected
+   and each line is painted with one QwtPainter::drawPolyline() call.
+
+   \sa renderContourLines(), defaultContourPen(), contourPen(),
+       QwtRasterData::connectedContourLines()
  */
 void QwtPlotSpectrogram::drawContourLines( QPainter* painter,
     const QwtScaleMap& xMap, const QwtScaleMap& yMap,
@@ -728,14 +907,37 @@ void QwtPlotSpectrogram::drawContourLines( QPainter* painter,
         painter->setPen( pen );
 
         const QPolygonF& lines = contourLines[level];
-        for ( int i = 0; i < lines.size(); i += 2 )
+
+        if ( m_data->conrecFlags & QwtRasterData::ConnectLines )
         {
-            const QPointF p1( xMap.transform( lines[i].x() ),
-                yMap.transform( lines[i].y() ) );
-            const QPointF p2( xMap.transform( lines[i + 1].x() ),
-                yMap.transform( lines[i + 1].y() ) );
+            const QVector< QPolygonF > polylines =
+                QwtRasterData::connectedContourLines( lines );
+
+            for ( int i = 0; i < polylines.size(); i++ )
+            {
+                QPolygonF polyline = polylines[i];
 
-            QwtPainter::drawLine( painter, p1, p2 );
+                QPointF* points = polyline.data();
+                for ( int j = 0; j < polyline.size(); j++ )
+                {
+                    points[j].rx() = xMap.transform( points[j].x() );
+                    points[j].ry() = yMap.transform( points[j].y() );
+                }
+
+                QwtPainter::drawPolyline( painter, polyline );
+            }
+        }
+        else
+        {
+            for ( int i = 0; i < lines.size(); i += 2 )
+            {
+                const QPointF p1( xMap.transform( lines[i].x() ),
+                    yMap.transform( lines[i].y() ) );
+                const QPointF p2( xMap.transform( lines[i + 1].x() ),
+                    yMap.transform( lines[i + 1].y() ) );
+
+                QwtPainter::drawLine( painter, p1, p2 );
+            }
         }
     }
 }
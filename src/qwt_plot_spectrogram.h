@@ -109,6 +109,11 @@ class QWT_EXPORT QwtPlotSpectrogram : public QwtPlotRasterItem
         const QRect& tile, QImage* ) const;
 
   private:
+    class AlphaColors;
+
+    void renderColorTile( const QwtScaleMap&, const QwtScaleMap&,
+        const QRect& tile, const AlphaColors*, QImage* ) const;
+
     class PrivateData;
     PrivateData* m_data;
 };
@@ -13,6 +13,7 @@
 #include "qwt_text.h"
 #include "qwt_graphic.h"
 #include "qwt_math.h"
+#include "qwt_date.h"
 
 #include <qpainter.h>
 
@@ -28,6 +29,255 @@ static inline bool qwtIsSampleInside( const QwtOHLCSample& sample,
     return !isOffScreen;
 }
 
+namespace
+{
+    // buckets of a fixed width in paint device coordinates
+    class PixelBuckets
+    {
+      public:
+        PixelBuckets( const QwtScaleMap& map, double width )
+            : m_map( map )
+            , m_width( width )
+            , m_isLinear( map.transformation() == NULL )
+        {
+            if ( m_isLinear )
+                m_width *= map.sDist() / map.pDist();
+        }
+
+        inline void bucket( double t, double& start, double& end ) const
+        {
+            if ( m_isLinear )
+            {
+                // aligned to scale coordinates, so that
+                // the buckets do not change, when panning
+
+                start = std::floor( t / m_width ) * m_width;
+                end = start + m_width;
+            }
+            else
+            {
+                const double p =
+                    std::floor( m_map.transform( t ) / m_width ) * m_width;
+
+                start = m_map.invTransform( p );
+                end = m_map.invTransform( p + m_width );
+
+                if ( start > end )
+                    qSwap( start, end );
+            }
+        }
+
+      private:
+        const QwtScaleMap& m_map;
+        double m_width;
+        const bool m_isLinear;
+    };
+
+    // buckets aligned to calendar intervals
+    class CalendarBuckets
+    {
+      public:
+        CalendarBuckets( QwtDate::IntervalType type,
+                int step, Qt::TimeSpec timeSpec )
+            : m_type( type )
+            , m_step( step )
+            , m_timeSpec( timeSpec )
+        {
+        }
+
+        inline void bucket( double t, double& start, double& end ) const
+        {
+            QDateTime dt = QwtDate::floor(
+                QwtDate::toDateTime( t, m_timeSpec ), m_type );
+
+            if ( m_step > 1 )
+            {
+                switch( m_type )
+                {
+                    case QwtDate::Millisecond:
+                        dt = dt.addMSecs( -( dt.time().msec() % m_step ) );
+                        break;
+                    case QwtDate::Second:
+                        dt = dt.addSecs( -( dt.time().second() % m_step ) );
+                        break;
+                    case QwtDate::Minute:
+                        dt = dt.addSecs( -60 * ( dt.time().minute() % m_step ) );
+                        break;
+                    case QwtDate::Hour:
+                        dt = dt.addSecs( -3600 * ( dt.time().hour() % m_step ) );
+                        break;
+                    case QwtDate::Month:
+                        dt = dt.addMonths( -( ( dt.date().month() - 1 ) % m_step ) );
+                        break;
+                    case QwtDate::Year:
+                    {
+                        const int year = dt.date().year();
+                        dt = dt.addYears( -( ( year % m_step + m_step ) % m_step ) );
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+
+            start = QwtDate::toDouble( dt );
+
+            switch( m_type )
+            {
+                case QwtDate::Millisecond:
+                    dt = dt.addMSecs( m_step );
+                    break;
+                case QwtDate::Second:
+                    dt = dt.addSecs( m_step );
+                    break;
+                case QwtDate::Minute:
+                    dt = dt.addSecs( 60 * m_step );
+                    break;
+                case QwtDate::Hour:
+                    dt = dt.addSecs( 3600 * m_step );
+                    break;
+                case QwtDate::Day:
+                    dt = dt.addDays( m_step );
+                    break;
+                case QwtDate::Week:
+                    dt = dt.addDays( 7 * m_step );
+                    break;
+                case QwtDate::Month:
+                    dt = dt.addMonths( m_step );
+                    break;
+                case QwtDate::Year:
+                    dt = dt.addYears( m_step );
+                    break;
+            }
+
+            end = QwtDate::toDouble( dt );
+        }
+
+      private:
+        const QwtDate::IntervalType m_type;
+        const int m_step;
+        const Qt::TimeSpec m_timeSpec;
+    };
+
+    class CalendarStep
+    {
+      public:
+        QwtDate::IntervalType type;
+        int step;
+
+        // length in milliseconds
+        double length;
+    };
+}
+
+static CalendarStep qwtCalendarStep( double length )
+{
+    const double second = 1000.0;
+    const double minute = 60.0 * second;
+    const double hour = 60.0 * minute;
+    const double day = 24.0 * hour;
+    const double year = 365.2425 * day;
+
+    static const CalendarStep steps[] =
+    {
+        { QwtDate::Millisecond, 1, 1.0 },
+        { QwtDate::Millisecond, 10, 10.0 },
+        { QwtDate::Millisecond, 100, 100.0 },
+        { QwtDate::Second, 1, second },
+        { QwtDate::Second, 5, 5 * second },
+        { QwtDate::Second, 15, 15 * second },
+        { QwtDate::Second, 30, 30 * second },
+        { QwtDate::Minute, 1, minute },
+        { QwtDate::Minute, 5, 5 * minute },
+        { QwtDate::Minute, 15, 15 * minute },
+        { QwtDate::Minute, 30, 30 * minute },
+        { QwtDate::Hour, 1, hour },
+        { QwtDate::Hour, 2, 2 * hour },
+        { QwtDate::Hour, 4, 4 * hour },
+        { QwtDate::Hour, 6, 6 * hour },
+        { QwtDate::Hour, 12, 12 * hour },
+        { QwtDate::Day, 1, day },
+        { QwtDate::Week, 1, 7 * day },
+        { QwtDate::Month, 1, year / 12 },
+        { QwtDate::Month, 3, year / 4 },
+        { QwtDate::Month, 6, year / 2 },
+        { QwtDate::Year, 1, year }
+    };
+
+    const int numSteps = sizeof( steps ) / sizeof( steps[0] );
+
+    for ( int i = 0; i < numSteps; i++ )
+    {
+        if ( steps[i].length >= length )
+            return steps[i];
+    }
+
+    CalendarStep step;
+    step.type = QwtDate::Year;
+    step.step = qwtCeil( length / year );
+    step.length = step.step * year;
+
+    return step;
+}
+
+// index of the first sample with a time >= t
+static int qwtLowerIndex( const QwtSeriesData< QwtOHLCSample >* series,
+    int from, int to, double t )
+{
+    int lower = from;
+    int upper = to + 1;
+
+    while ( lower < upper )
+    {
+        const int mid = lower + ( upper - lower ) / 2;
+
+        if ( series->sample( mid ).time < t )
+            lower = mid + 1;
+        else
+            upper = mid;
+    }
+
+    return lower;
+}
+
+template< class Buckets >
+static void qwtAggregate( const QwtSeriesData< QwtOHLCSample >* series,
+    int from, int to, const Buckets& buckets, QVector< QwtOHLCSample >& samples )
+{
+    double start = 0.0;
+    double end = 0.0;
+
+    QwtOHLCSample bucketSample;
+    bool isOpen = false;
+
+    for ( int i = from; i <= to; i++ )
+    {
+        const QwtOHLCSample s = series->sample( i );
+
+        if ( isOpen && s.time >= start && s.time < end )
+        {
+            bucketSample.high = qwtMaxF( bucketSample.high, s.high );
+            bucketSample.low = qwtMinF( bucketSample.low, s.low );
+            bucketSample.close = s.close;
+        }
+        else
+        {
+            if ( isOpen )
+                samples += bucketSample;
+
+            buckets.bucket( s.time, start, end );
+
+            bucketSample = s;
+            bucketSample.time = 0.5 * ( start + end );
+
+            isOpen = true;
+        }
+    }
+
+    if ( isOpen )
+        samples += bucketSample;
+}
+
 class QwtPlotTradingCurve::PrivateData
 {
   public:
@@ -37,6 +287,9 @@ class QwtPlotTradingCurve::PrivateData
         , minSymbolWidth( 2.0 )
         , maxSymbolWidth( -1.0 )
         , paintAttributes( QwtPlotTradingCurve::ClipSymbols )
+        , aggregation( QwtPlotTradingCurve::NoAggregation )
+        , aggregationWidth( 4.0 )
+        , timeSpec( Qt::LocalTime )
     {
         symbolBrush[0] = QBrush( Qt::white );
         symbolBrush[1] = QBrush( Qt::black );
@@ -51,6 +304,10 @@ class QwtPlotTradingCurve::PrivateData
     QBrush symbolBrush[2]; // Increasing/Decreasing
 
     QwtPlotTradingCurve::PaintAttributes paintAttributes;
+
+    QwtPlotTradingCurve::Aggregation aggregation;
+    double aggregationWidth;
+    Qt::TimeSpec timeSpec;
 };
 
 /*!
@@ -358,6 +615,89 @@ double QwtPlotTradingCurve::maxSymbolWidth() const
     return m_data->maxSymbolWidth;
 }
 
+/*!
+   \brief Set the aggregation of samples
+
+   \param aggregation Aggregation mode
+   \sa Aggregation, aggregation(), setAggregationWidth()
+ */
+void QwtPlotTradingCurve::setAggregation( Aggregation aggregation )
+{
+    if ( aggregation != m_data->aggregation )
+    {
+        m_data->aggregation = aggregation;
+        itemChanged();
+    }
+}
+
+/*!
+   \return Aggregation mode
+   \sa setAggregation(), aggregationWidth()
+ */
+QwtPlotTradingCurve::Aggregation QwtPlotTradingCurve::aggregation() const
+{
+    return m_data->aggregation;
+}
+
+/*!
+   \brief Set the minimum width of an aggregation bucket
+
+   Samples are only aggregated, when there are more samples than buckets.
+   The aggregated symbols have a width of 60% of the bucket width - bounded by
+   minSymbolWidth() and maxSymbolWidth().
+
+   The default setting is 4.0.
+
+   \param width Width in paint device coordinates
+   \sa aggregationWidth(), setAggregation()
+ */
+void QwtPlotTradingCurve::setAggregationWidth( double width )
+{
+    width = qwtMaxF( width, 1.0 );
+    if ( width != m_data->aggregationWidth )
+    {
+        m_data->aggregationWidth = width;
+        itemChanged();
+    }
+}
+
+/*!
+   \return Minimum width of an aggregation bucket
+   \sa setAggregationWidth(), aggregation()
+ */
+double QwtPlotTradingCurve::aggregationWidth() const
+{
+    return m_data->aggregationWidth;
+}
+
+/*!
+   \brief Set the time specification used for aligning calendar buckets
+
+   The default setting is Qt::LocalTime.
+
+   \param timeSpec Time specification
+   \sa timeSpec(), CalendarAggregation, QwtDateScaleEngine::setTimeSpec()
+ */
+void QwtPlotTradingCurve::setTimeSpec( Qt::TimeSpec timeSpec )
+{
+    if ( timeSpec != m_data->timeSpec )
+    {
+        m_data->timeSpec = timeSpec;
+
+        if ( m_data->aggregation == CalendarAggregation )
+            itemChanged();
+    }
+}
+
+/*!
+   \return Time specification used for aligning calendar buckets
+   \sa setTimeSpec()
+ */
+Qt::TimeSpec QwtPlotTradingCurve::timeSpec() const
+{
+    return m_data->timeSpec;
+}
+
 /*!
    \return Bounding rectangle of all samples.
    For an empty series the rectangle is invalid.
@@ -452,7 +792,24 @@ void QwtPlotTradingCurve::drawSymbols( QPainter* painter,
     const bool doClip = m_data->paintAttributes & ClipSymbols;
     const bool doAlign = QwtPainter::roundingAlignment( painter );
 
-    double symbolWidth = scaledSymbolWidth( xMap, yMap, canvasRect );
+    QVector< QwtOHLCSample > buckets;
+    double bucketWidth = 0.0;
+
+    if ( m_data->aggregation != NoAggregation )
+        bucketWidth = aggregate( *timeMap, tMin, tMax, from, to, buckets );
+
+    double symbolWidth;
+    if ( bucketWidth > 0.0 )
+    {
+        symbolWidth = qwtMaxF( 0.6 * bucketWidth, m_data->minSymbolWidth );
+        if ( m_data->maxSymbolWidth > 0.0 )
+            symbolWidth = qwtMinF( symbolWidth, m_data->maxSymbolWidth );
+    }
+    else
+    {
+        symbolWidth = scaledSymbolWidth( xMap, yMap, canvasRect );
+    }
+
     if ( doAlign )
         symbolWidth = std::floor( 0.5 * symbolWidth ) * 2.0;
 
@@ -461,9 +818,13 @@ void QwtPlotTradingCurve::drawSymbols( QPainter* painter,
 
     painter->setPen( pen );
 
-    for ( int i = from; i <= to; i++ )
+    const int numSamples = ( bucketWidth > 0.0 )
+        ? buckets.size() : ( to - from + 1 );
+
+    for ( int i = 0; i < numSamples; i++ )
     {
-        const QwtOHLCSample s = sample( i );
+        const QwtOHLCSample s = ( bucketWidth > 0.0 )
+            ? buckets[i] : sample( from + i );
 
         if ( !doClip || qwtIsSampleInside( s, tMin, tMax, vMin, vMax ) )
         {
@@ -517,6 +878,79 @@ void QwtPlotTradingCurve::drawSymbols( QPainter* painter,
     }
 }
 
+/*!
+   Aggregate the samples of the visible interval
+
+   \param timeMap Map for the time values
+   \param tMin Minimum of the visible time interval
+   \param tMax Maximum of the visible time interval
+   \param from Index of the first sample
+   \param to Index of the last sample
+   \param samples Aggregated samples
+
+   \return Width of a bucket in paint device coordinates or 0.0,
+           when there are not more samples than buckets
+
+   \sa setAggregation()
+ */
+double QwtPlotTradingCurve::aggregate( const QwtScaleMap& timeMap,
+    double tMin, double tMax, int from, int to,
+    QVector< QwtOHLCSample >& samples ) const
+{
+    if ( timeMap.pDist() <= 0.0 || timeMap.sDist() <= 0.0 )
+        return 0.0;
+
+    const QwtSeriesData< QwtOHLCSample >* series = data();
+
+    const double width = m_data->aggregationWidth;
+
+    double bucketWidth = width;
+    double start, end;
+
+    if ( m_data->aggregation == CalendarAggregation )
+    {
+        const double length = qAbs( timeMap.invTransform( timeMap.p1() + width )
+            - timeMap.invTransform( timeMap.p1() ) );
+
+        const CalendarStep step = qwtCalendarStep( length );
+
+        const CalendarBuckets buckets( step.type, step.step, m_data->timeSpec );
+
+        double dummy;
+        buckets.bucket( qMin( tMin, tMax ), start, dummy );
+        buckets.bucket( qMax( tMin, tMax ), dummy, end );
+
+        from = qwtLowerIndex( series, from, to, start );
+        to = qwtLowerIndex( series, from, to, end ) - 1;
+
+        qwtAggregate( series, from, to, buckets, samples );
+
+        bucketWidth = width * step.length / length;
+    }
+    else
+    {
+        const PixelBuckets buckets( timeMap, width );
+
+        double dummy;
+        buckets.bucket( qMin( tMin, tMax ), start, dummy );
+        buckets.bucket( qMax( tMin, tMax ), dummy, end );
+
+        from = qwtLowerIndex( series, from, to, start );
+        to = qwtLowerIndex( series, from, to, end ) - 1;
+
+        qwtAggregate( series, from, to, buckets, samples );
+    }
+
+    if ( samples.size() >= to - from + 1 )
+    {
+        // nothing to merge
+        samples.clear();
+        return 0.0;
+    }
+
+    return bucketWidth;
+}
+
 /*!
    \brief Draw a symbol for a symbol style >= UserSymbol
 
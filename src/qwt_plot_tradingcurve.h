@@ -100,6 +100,43 @@ class QWT_EXPORT QwtPlotTradingCurve
 
     Q_DECLARE_FLAGS( PaintAttributes, PaintAttribute )
 
+    /*!
+        \brief Aggregation of samples
+
+        When many samples are mapped into a few pixels their symbols
+        are painted on top of each other. Aggregating merges consecutive
+        samples into buckets, that are displayed by one symbol: the open
+        value of the first, the close value of the last and the
+        minimum/maximum of all samples in the bucket.
+
+        The aggregated samples are calculated for the visible interval only.
+        This requires the samples being ordered by time.
+
+        The default setting is NoAggregation.
+        \sa setAggregation(), setAggregationWidth()
+     */
+    enum Aggregation
+    {
+        //! Each sample is displayed by its own symbol
+        NoAggregation,
+
+        /*!
+           The buckets have a width of aggregationWidth() in
+           paint device coordinates.
+         */
+        PixelAggregation,
+
+        /*!
+           The buckets are aligned to calendar intervals ( f.e 15 minutes,
+           a day or a month ). The shortest interval, that is not smaller
+           than aggregationWidth() in paint device coordinates is used.
+
+           The time values are interpreted like in QwtDate and
+           the buckets are aligned according to timeSpec().
+         */
+        CalendarAggregation
+    };
+
     explicit QwtPlotTradingCurve( const QString& title = QString() );
     explicit QwtPlotTradingCurve( const QwtText& title );
 
@@ -133,6 +170,15 @@ class QWT_EXPORT QwtPlotTradingCurve
     void setMaxSymbolWidth( double );
     double maxSymbolWidth() const;
 
+    void setAggregation( Aggregation );
+    Aggregation aggregation() const;
+
+    void setAggregationWidth( double );
+    double aggregationWidth() const;
+
+    void setTimeSpec( Qt::TimeSpec );
+    Qt::TimeSpec timeSpec() const;
+
     virtual void drawSeries( QPainter*,
         const QwtScaleMap& xMap, const QwtScaleMap& yMap,
         const QRectF& canvasRect, int from, int to ) const QWT_OVERRIDE;
@@ -164,6 +210,9 @@ class QWT_EXPORT QwtPlotTradingCurve
         const QRectF& canvasRect ) const;
 
   private:
+    double aggregate( const QwtScaleMap& timeMap, double tMin, double tMax,
+        int from, int to, QVector< QwtOHLCSample >& ) const;
+
     class PrivateData;
     PrivateData* m_data;
 };
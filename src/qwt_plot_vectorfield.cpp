@@ -19,9 +19,16 @@
 #include <qpainter.h>
 #include <qpainterpath.h>
 #include <qdebug.h>
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
 #include <cstdlib>
 #include <limits>
 
+#if !defined( QT_NO_QFUTURE )
+#define QWT_USE_THREADS 1
+#endif
+
 #define DEBUG_RENDER 0
 
 #if DEBUG_RENDER
@@ -220,6 +227,30 @@ namespace
             return m_entries;
         }
 
+        // adding the entries of a matrix with the same geometry
+        void add( const FilterMatrix& other )
+        {
+            if ( m_entries == NULL || other.m_entries == NULL )
+                return;
+
+            const int numEntries = m_numRows * m_numColumns;
+
+            for ( int i = 0; i < numEntries; i++ )
+            {
+                const Entry& e = other.m_entries[i];
+                if ( e.count > 0 )
+                {
+                    Entry& entry = m_entries[i];
+
+                    entry.x += e.x;
+                    entry.y += e.y;
+                    entry.vx += e.vx;
+                    entry.vy += e.vy;
+                    entry.count += e.count;
+                }
+            }
+        }
+
       private:
         inline int indexOf( qreal x, qreal y ) const
         {
@@ -235,6 +266,123 @@ namespace
 
         Entry* m_entries;
     };
+
+    // Helper class to work around the 5 parameters
+    // limitation of QtConcurrent::run()
+    class FilterCommand
+    {
+      public:
+        const QwtSeriesData< QwtVectorFieldSample >* series;
+        int from;
+        int to;
+    };
+
+    class SymbolBatch
+    {
+      public:
+        SymbolBatch( const QwtPlotVectorField* vectorField,
+                QwtVectorFieldSymbol* symbol, const QwtColorMap* colorMap,
+                const QwtInterval& magnitudeRange )
+            : m_vectorField( vectorField )
+            , m_symbol( symbol )
+            , m_colorMap( colorMap )
+            , m_magnitudeRange( magnitudeRange )
+        {
+            if ( m_colorMap )
+                m_colors = m_colorMap->colorTable( 256 );
+
+            m_paths.resize( m_colorMap ? m_colors.size() : 1 );
+
+            // overlapping symbols must not cancel each other out
+            for ( int i = 0; i < m_paths.size(); i++ )
+                m_paths[i].setFillRule( Qt::WindingFill );
+        }
+
+        void addSymbol( double x, double y, double vx, double vy )
+        {
+            const double magnitude = qwtVector2Magnitude( vx, vy );
+
+            QTransform transform = qwtSymbolTransformation( QTransform(),
+                x, y, vx, vy, magnitude );
+
+            double length = 0.0;
+
+            if ( m_vectorField->testMagnitudeMode(
+                QwtPlotVectorField::MagnitudeAsLength ) )
+            {
+                length = m_vectorField->arrowLength( magnitude );
+            }
+
+            m_symbol->setLength( length );
+
+            const QwtPlotVectorField::IndicatorOrigin origin =
+                m_vectorField->indicatorOrigin();
+
+            if( origin == QwtPlotVectorField::OriginTail )
+            {
+                const qreal dx = m_symbol->length();
+                transform.translate( dx, 0.0 );
+            }
+            else if ( origin == QwtPlotVectorField::OriginCenter )
+            {
+                const qreal dx = m_symbol->length();
+                transform.translate( 0.5 * dx, 0.0 );
+            }
+
+            int index = 0;
+            if ( m_colorMap )
+            {
+                index = m_colorMap->colorIndex(
+                    m_colors.size(), m_magnitudeRange, magnitude );
+            }
+
+            m_paths[index].addPath( transform.map( m_symbol->path() ) );
+        }
+
+        void paint( QPainter* painter ) const
+        {
+            for ( int i = 0; i < m_paths.size(); i++ )
+            {
+                if ( m_paths[i].isEmpty() )
+                    continue;
+
+                if ( m_colorMap )
+                {
+                    const QColor c( m_colors[i] );
+
+                    painter->setBrush( c );
+                    painter->setPen( c );
+                }
+
+                painter->drawPath( m_paths[i] );
+            }
+        }
+
+      private:
+        const QwtPlotVectorField* m_vectorField;
+        QwtVectorFieldSymbol* m_symbol;
+
+        const QwtColorMap* m_colorMap;
+        const QwtInterval m_magnitudeRange;
+
+        QVector< QRgb > m_colors;
+        QVector< QPainterPath > m_paths;
+    };
+}
+
+static void qwtFilterSamples(
+    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+    const FilterCommand& command, FilterMatrix* matrix )
+{
+    for ( int i = command.from; i <= command.to; i++ )
+    {
+        const QwtVectorFieldSample sample = command.series->sample( i );
+        if ( !sample.isNull() )
+        {
+            matrix->addSample( xMap.transform( sample.x ),
+                yMap.transform( sample.y ), sample.vx, sample.vy );
+        }
+    }
 }
 
 class QwtPlotVectorField::PrivateData
@@ -869,6 +1017,31 @@ void QwtPlotVectorField::drawSymbols( QPainter* painter,
         painter->setBrush( m_data->brush );
     }
 
+    SymbolBatch* batch = NULL;
+
+    if ( ( m_data->paintAttributes & BatchSymbols )
+        && !m_data->symbol->path().isEmpty() )
+    {
+        const QwtColorMap* colorMap = NULL;
+        QwtInterval range;
+
+        if ( m_data->magnitudeModes & MagnitudeAsColor )
+        {
+            colorMap = m_data->colorMap;
+
+            range = m_data->magnitudeRange;
+            if ( !range.isValid() )
+            {
+                if ( !m_data->boundingMagnitudeRange.isValid() )
+                    m_data->boundingMagnitudeRange = qwtMagnitudeRange( series );
+
+                range = m_data->boundingMagnitudeRange;
+            }
+        }
+
+        batch = new SymbolBatch( this, m_data->symbol, colorMap, range );
+    }
+
     if ( ( m_data->paintAttributes & FilterVectors ) && !m_data->rasterSize.isEmpty() )
     {
         const QRectF dataRect = QwtScaleMap::transform(
@@ -896,14 +1069,68 @@ void QwtPlotVectorField::drawSymbols( QPainter* painter,
         FilterMatrix matrix( dataRect, canvasRect, canvasRasterSize );
 #endif
 
-        for ( int i = from; i <= to; i++ )
+        FilterCommand command;
+        command.series = series;
+
+        uint numThreads = 1;
+
+#if QWT_USE_THREADS
+        numThreads = renderThreadCount();
+
+        if ( numThreads == 0 )
+            numThreads = QThread::idealThreadCount();
+
+        if ( numThreads <= 0 )
+            numThreads = 1;
+
+        // each thread needs its own matrix, what is only worth
+        // the effort for many samples
+
+        const int minSamplesPerThread = 10000;
+        numThreads = qBound( 1, ( to - from + 1 ) / minSamplesPerThread,
+            static_cast< int >( numThreads ) );
+
+        if ( numThreads > 1 )
         {
-            const QwtVectorFieldSample sample = series->sample( i );
-            if ( !sample.isNull() )
+            const int numSamples = ( to - from + 1 ) / numThreads;
+
+            QList< FilterMatrix* > matrices;
+            QList< QFuture< void > > futures;
+
+            for ( uint i = 0; i < numThreads - 1; i++ )
+            {
+                command.from = from + i * numSamples;
+                command.to = command.from + numSamples - 1;
+
+                FilterMatrix* m = new FilterMatrix(
+                    dataRect, canvasRect, m_data->rasterSize );
+
+                matrices += m;
+                futures += QtConcurrent::run( &qwtFilterSamples,
+                    xMap, yMap, command, m );
+            }
+
+            command.from = from + ( numThreads - 1 ) * numSamples;
+            command.to = to;
+
+            qwtFilterSamples( xMap, yMap, command, &matrix );
+
+            for ( int i = 0; i < futures.size(); i++ )
             {
-                matrix.addSample( xMap.transform( sample.x ),
-                    yMap.transform( sample.y ), sample.vx, sample.vy );
+                futures[i].waitForFinished();
+                matrix.add( *matrices[i] );
             }
+
+            qDeleteAll( matrices );
+        }
+#endif
+
+        if ( numThreads <= 1 )
+        {
+            command.from = from;
+            command.to = to;
+
+            qwtFilterSamples( xMap, yMap, command, &matrix );
         }
 
         const int numEntries = matrix.numRows() * matrix.numColumns();
@@ -925,11 +1152,19 @@ void QwtPlotVectorField::drawSymbols( QPainter* painter,
                 yi = qRound( yi );
             }
 
-            const double vx = entry.vx / entry.count;
-            const double vy = entry.vy / entry.count;
+            double vx = entry.vx / entry.count;
+            double vy = entry.vy / entry.count;
+
+            if ( isInvertingX )
+                vx = -vx;
 
-            drawSymbol( painter, xi, yi,
-                isInvertingX ? -vx : vx, isInvertingY ? -vy : vy );
+            if ( isInvertingY )
+                vy = -vy;
+
+            if ( batch )
+                batch->addSymbol( xi, yi, vx, vy );
+            else
+                drawSymbol( painter, xi, yi, vx, vy );
         }
     }
     else
@@ -957,11 +1192,21 @@ void QwtPlotVectorField::drawSymbols( QPainter* painter,
                     continue;
             }
 
-            drawSymbol( painter, xi, yi,
-                isInvertingX ? -sample.vx : sample.vx,
-                isInvertingY ? -sample.vy : sample.vy );
+            const double vx = isInvertingX ? -sample.vx : sample.vx;
+            const double vy = isInvertingY ? -sample.vy : sample.vy;
+
+            if ( batch )
+                batch->addSymbol( xi, yi, vx, vy );
+            else
+                drawSymbol( painter, xi, yi, vx, vy );
         }
     }
+
+    if ( batch )
+    {
+        batch->paint( painter );
+        delete batch;
+    }
 }
 
 /*!
@@ -1018,7 +1263,10 @@ void QwtPlotVectorField::drawSymbol( QPainter* painter,
             range = m_data->boundingMagnitudeRange;
         }
 
-        const QColor c = m_data->colorMap->rgb( range, magnitude );
+        QRgb rgb;
+        m_data->colorMap->rgbValues( range, &magnitude, 1, &rgb );
+
+        const QColor c( rgb );
 
 #if 1
         painter->setBrush( c );
@@ -59,9 +59,26 @@ class QWT_EXPORT QwtPlotVectorField
             that lie in the same cell of a grid that is determined by
             setting the rasterSize().
 
+            For large series the samples are distributed to the cells
+            in parallel by renderThreadCount() threads.
+
             \sa setRasterSize()
          */
-        FilterVectors        = 0x01
+        FilterVectors        = 0x01,
+
+        /*
+            BatchSymbols collects the geometries of all symbols with the
+            same color into one path, that is painted at once. In
+            MagnitudeAsColor mode the magnitudes are mapped into a
+            table of 256 colors.
+
+            Symbols, that overlap, might be painted in a different order
+            and drawSymbol() is not called. BatchSymbols has no effect,
+            when QwtVectorFieldSymbol::path() returns an empty path.
+
+            \sa QwtVectorFieldSymbol::path()
+         */
+        BatchSymbols         = 0x02
     };
 
     Q_DECLARE_FLAGS( PaintAttributes, PaintAttribute )
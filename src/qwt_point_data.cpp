@@ -21,6 +21,7 @@ QwtSyntheticPointData::QwtSyntheticPointData(
         size_t size, const QwtInterval& interval )
     : m_size( size )
     , m_interval( interval )
+    , m_revision( 0 )
 {
 }
 
@@ -33,6 +34,7 @@ QwtSyntheticPointData::QwtSyntheticPointData(
 void QwtSyntheticPointData::setSize( size_t size )
 {
     m_size = size;
+    updateRevision();
 }
 
 /*!
@@ -53,6 +55,7 @@ size_t QwtSyntheticPointData::size() const
 void QwtSyntheticPointData::setInterval( const QwtInterval& interval )
 {
     m_interval = interval.normalized();
+    updateRevision();
 }
 
 /*!
@@ -77,9 +80,19 @@ QwtInterval QwtSyntheticPointData::interval() const
  */
 void QwtSyntheticPointData::setRectOfInterest( const QRectF& rect )
 {
-    m_rectOfInterest = rect;
-    m_intervalOfInterest = QwtInterval(
+    const QwtInterval intervalOfInterest = QwtInterval(
         rect.left(), rect.right() ).normalized();
+
+    m_rectOfInterest = rect;
+
+    if ( intervalOfInterest != m_intervalOfInterest )
+    {
+        m_intervalOfInterest = intervalOfInterest;
+
+        // the x values are calculated from the interval of interest
+        if ( !m_interval.isValid() )
+            updateRevision();
+    }
 }
 
 /*!
@@ -91,6 +104,26 @@ QRectF QwtSyntheticPointData::rectOfInterest() const
     return m_rectOfInterest;
 }
 
+/*!
+   \return Revision of the points, that changes with size(),
+           interval() and the rectangle of interest
+
+   \note Changes of the parameters of a derived class, that
+         are used by y(), are not indicated.
+
+   \sa QwtSeriesData::revision()
+ */
+quint64 QwtSyntheticPointData::revision() const
+{
+    return m_revision;
+}
+
+void QwtSyntheticPointData::updateRevision()
+{
+    // more than the number of points: not an append
+    m_revision += m_size + 1;
+}
+
 /*!
    \brief Calculate the bounding rectangle
 
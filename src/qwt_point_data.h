@@ -15,6 +15,24 @@
 
 #include <cstring>
 
+// Only arrays of doubles can be exposed by contiguousValues()
+
+template< typename T >
+inline bool qwtContiguousValues( const T*, const T*,
+    const double**, const double** )
+{
+    return false;
+}
+
+inline bool qwtContiguousValues( const double* x, const double* y,
+    const double** xValues, const double** yValues )
+{
+    *xValues = x;
+    *yValues = y;
+
+    return true;
+}
+
 /*!
    \brief Interface for iterating over two QVector<T> objects.
  */
@@ -28,6 +46,9 @@ class QwtPointArrayData : public QwtSeriesData< QPointF >
     virtual size_t size() const QWT_OVERRIDE;
     virtual QPointF sample( size_t index ) const QWT_OVERRIDE;
 
+    virtual bool contiguousValues(
+        const double** xValues, const double** yValues ) const QWT_OVERRIDE;
+
     const QVector< T >& xData() const;
     const QVector< T >& yData() const;
 
@@ -48,6 +69,9 @@ class QwtCPointerData : public QwtSeriesData< QPointF >
     virtual size_t size() const QWT_OVERRIDE;
     virtual QPointF sample( size_t index ) const QWT_OVERRIDE;
 
+    virtual bool contiguousValues(
+        const double** xValues, const double** yValues ) const QWT_OVERRIDE;
+
     const T* xData() const;
     const T* yData() const;
 
@@ -181,11 +205,16 @@ class QWT_EXPORT QwtSyntheticPointData : public QwtSeriesData< QPointF >
     virtual void setRectOfInterest( const QRectF& ) QWT_OVERRIDE;
     QRectF rectOfInterest() const;
 
+    virtual quint64 revision() const QWT_OVERRIDE;
+
   private:
+    void updateRevision();
+
     size_t m_size;
     QwtInterval m_interval;
     QRectF m_rectOfInterest;
     QwtInterval m_intervalOfInterest;
+    quint64 m_revision;
 };
 
 /*!
@@ -241,6 +270,21 @@ QPointF QwtPointArrayData< T >::sample( size_t index ) const
     return QPointF( m_x[int( index )], m_y[int( index )] );
 }
 
+/*!
+   \brief Direct access to the x and y coordinates
+
+   \param xValues Return parameter for the x coordinates
+   \param yValues Return parameter for the y coordinates
+
+   \return true, when T is double
+ */
+template< typename T >
+bool QwtPointArrayData< T >::contiguousValues(
+    const double** xValues, const double** yValues ) const
+{
+    return qwtContiguousValues( m_x.constData(), m_y.constData(), xValues, yValues );
+}
+
 //! \return Array of the x-values
 template< typename T >
 const QVector< T >& QwtPointArrayData< T >::xData() const
@@ -349,6 +393,21 @@ QPointF QwtCPointerData< T >::sample( size_t index ) const
     return QPointF( m_x[int( index )], m_y[int( index )] );
 }
 
+/*!
+   \brief Direct access to the x and y coordinates
+
+   \param xValues Return parameter for the x coordinates
+   \param yValues Return parameter for the y coordinates
+
+   \return true, when T is double
+ */
+template< typename T >
+bool QwtCPointerData< T >::contiguousValues(
+    const double** xValues, const double** yValues ) const
+{
+    return qwtContiguousValues( m_x, m_y, xValues, yValues );
+}
+
 //! \return Array of the x-values
 template< typename T >
 const T* QwtCPointerData< T >::xData() const
@@ -0,0 +1,365 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_point_index.h"
+#include "qwt_scale_map.h"
+#include "qwt_series_data.h"
+#include "qwt_math.h"
+
+#include <qrect.h>
+
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+#include <algorithm>
+
+#if !defined( QT_NO_QFUTURE )
+#define QWT_USE_THREADS 1
+#endif
+
+namespace
+{
+    class Node
+    {
+      public:
+        QPointF pos;
+        int index;
+    };
+
+    class LessX
+    {
+      public:
+        inline bool operator()( const Node& node1, const Node& node2 ) const
+        {
+            return node1.pos.x() < node2.pos.x();
+        }
+    };
+
+    class LessY
+    {
+      public:
+        inline bool operator()( const Node& node1, const Node& node2 ) const
+        {
+            return node1.pos.y() < node2.pos.y();
+        }
+    };
+
+    // ranges below this size are not split any further
+    const int qwtLeafSize = 8;
+
+    // ranges below this size are not split in parallel
+    const int qwtMinParallelSize = 100000;
+
+    class ClosestSearch
+    {
+      public:
+        ClosestSearch( const QwtScaleMap& xMap,
+                const QwtScaleMap& yMap, const QPointF& pos )
+            : xMap( xMap )
+            , yMap( yMap )
+            , pos( pos )
+            , index( -1 )
+            , dmin( 1.0e10 )
+        {
+        }
+
+        inline void test( const Node& node )
+        {
+            const double cx = xMap.transform( node.pos.x() ) - pos.x();
+            const double cy = yMap.transform( node.pos.y() ) - pos.y();
+
+            const double f = qwtSqr( cx ) + qwtSqr( cy );
+
+            // in case of equal distances the lowest index wins
+            // like when iterating over all points
+
+            if ( f < dmin || ( f == dmin && node.index < index ) )
+            {
+                index = node.index;
+                dmin = f;
+            }
+        }
+
+        const QwtScaleMap& xMap;
+        const QwtScaleMap& yMap;
+        const QPointF pos;
+
+        int index;
+        double dmin;
+    };
+}
+
+/*
+   The tree is stored implicitly: the median of each range is
+   the node, that splits the range into the ranges left and right
+   of it. The coordinate used for splitting alternates with the depth.
+ */
+static void qwtBuildTree( Node* nodes, int from, int to, int depth )
+{
+    if ( to - from <= qwtLeafSize )
+        return;
+
+    const int mid = from + ( to - from ) / 2;
+
+    if ( depth % 2 == 0 )
+        std::nth_element( nodes + from, nodes + mid, nodes + to, LessX() );
+    else
+        std::nth_element( nodes + from, nodes + mid, nodes + to, LessY() );
+
+#if QWT_USE_THREADS
+    if ( depth < 3 && ( to - from ) >= qwtMinParallelSize )
+    {
+        QFuture< void > future = QtConcurrent::run(
+            &qwtBuildTree, nodes, from, mid, depth + 1 );
+
+        qwtBuildTree( nodes, mid + 1, to, depth + 1 );
+
+        future.waitForFinished();
+        return;
+    }
+#endif
+
+    qwtBuildTree( nodes, from, mid, depth + 1 );
+    qwtBuildTree( nodes, mid + 1, to, depth + 1 );
+}
+
+static void qwtFindClosest( const Node* nodes,
+    int from, int to, int depth, ClosestSearch& search )
+{
+    if ( to - from <= qwtLeafSize )
+    {
+        for ( int i = from; i < to; i++ )
+            search.test( nodes[i] );
+
+        return;
+    }
+
+    const int mid = from + ( to - from ) / 2;
+    const Node& node = nodes[mid];
+
+    search.test( node );
+
+    /*
+        As the scale maps are monotonic, the distance to the
+        splitting line in paint device coordinates is a lower bound
+        for the distance of all points on the other side.
+     */
+    double d;
+    if ( depth % 2 == 0 )
+        d = search.pos.x() - search.xMap.transform( node.pos.x() );
+    else
+        d = search.pos.y() - search.yMap.transform( node.pos.y() );
+
+    // the other side might contain points with smaller coordinates
+    const bool inverting = ( depth % 2 == 0 )
+        ? search.xMap.isInverting() : search.yMap.isInverting();
+
+    if ( inverting )
+        d = -d;
+
+    if ( d < 0.0 )
+    {
+        qwtFindClosest( nodes, from, mid, depth + 1, search );
+        if ( !( d * d > search.dmin ) )
+            qwtFindClosest( nodes, mid + 1, to, depth + 1, search );
+    }
+    else
+    {
+        qwtFindClosest( nodes, mid + 1, to, depth + 1, search );
+        if ( !( d * d > search.dmin ) )
+            qwtFindClosest( nodes, from, mid, depth + 1, search );
+    }
+}
+
+static inline bool qwtContains( const QRectF& rect, const QPointF& pos )
+{
+    return pos.x() >= rect.left() && pos.x() <= rect.right()
+        && pos.y() >= rect.top() && pos.y() <= rect.bottom();
+}
+
+static void qwtCollectPoints( const Node* nodes,
+    int from, int to, int depth, const QRectF& rect, QVector< int >& indices )
+{
+    if ( to - from <= qwtLeafSize )
+    {
+        for ( int i = from; i < to; i++ )
+        {
+            if ( qwtContains( rect, nodes[i].pos ) )
+                indices += nodes[i].index;
+        }
+
+        return;
+    }
+
+    const int mid = from + ( to - from ) / 2;
+    const Node& node = nodes[mid];
+
+    double value, min, max;
+    if ( depth % 2 == 0 )
+    {
+        value = node.pos.x();
+        min = rect.left();
+        max = rect.right();
+    }
+    else
+    {
+        value = node.pos.y();
+        min = rect.top();
+        max = rect.bottom();
+    }
+
+    if ( min <= value )
+        qwtCollectPoints( nodes, from, mid, depth + 1, rect, indices );
+
+    if ( qwtContains( rect, node.pos ) )
+        indices += node.index;
+
+    if ( value <= max )
+        qwtCollectPoints( nodes, mid + 1, to, depth + 1, rect, indices );
+}
+
+class QwtPointIndex::PrivateData
+{
+  public:
+    PrivateData()
+        : isNull( true )
+    {
+    }
+
+    bool isNull;
+    QVector< Node > nodes;
+};
+
+/*!
+   Constructor
+
+   Creates a null index
+ */
+QwtPointIndex::QwtPointIndex()
+{
+    m_data = new PrivateData();
+}
+
+//! Destructor
+QwtPointIndex::~QwtPointIndex()
+{
+    delete m_data;
+}
+
+/*!
+   \brief Build the index for the points of a series
+
+   The points are copied, so that the series might be modified or
+   deleted afterwards. But then the index has to be rebuilt
+   to find the modified points.
+
+   \param series Series of points
+   \sa reset()
+ */
+void QwtPointIndex::setSamples( const QwtSeriesData< QPointF >* series )
+{
+    m_data->nodes.clear();
+    m_data->isNull = false;
+
+    if ( series == NULL )
+        return;
+
+    const int numSamples = static_cast< int >( series->size() );
+
+    m_data->nodes.reserve( numSamples );
+
+    for ( int i = 0; i < numSamples; i++ )
+    {
+        const QPointF pos = series->sample( i );
+        if ( qIsNaN( pos.x() ) || qIsNaN( pos.y() ) )
+            continue;
+
+        Node node;
+        node.pos = pos;
+        node.index = i;
+
+        m_data->nodes += node;
+    }
+
+    qwtBuildTree( m_data->nodes.data(), 0, m_data->nodes.size(), 0 );
+}
+
+/*!
+   Release the memory of the index
+   \sa setSamples(), isNull()
+ */
+void QwtPointIndex::reset()
+{
+    m_data->nodes.clear();
+    m_data->nodes.squeeze();
+    m_data->isNull = true;
+}
+
+/*!
+   \return true, when the index has not been built since
+           construction or the last call of reset()
+ */
+bool QwtPointIndex::isNull() const
+{
+    return m_data->isNull;
+}
+
+//! \return Number of indexed points
+int QwtPointIndex::size() const
+{
+    return m_data->nodes.size();
+}
+
+/*!
+   Find the closest point for a specific position
+
+   The result is the same as iterating over all points and comparing
+   their distances to pos after mapping them into paint device coordinates.
+
+   \param xMap Maps x-values into paint device coordinates.
+   \param yMap Maps y-values into paint device coordinates.
+   \param pos Position in paint device coordinates
+   \param dist If dist != NULL, closestPoint() returns the distance between
+              the position and the closest point in paint device coordinates
+
+   \return Index of the closest point in the series, or -1 if none can
+           be found ( f.e when the index is empty )
+ */
+int QwtPointIndex::closestPoint(
+    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+    const QPointF& pos, double* dist ) const
+{
+    ClosestSearch search( xMap, yMap, pos );
+    qwtFindClosest( m_data->nodes.constData(),
+        0, m_data->nodes.size(), 0, search );
+
+    if ( dist )
+        *dist = std::sqrt( search.dmin );
+
+    return search.index;
+}
+
+/*!
+   Find all points inside of a rectangle
+
+   \param rect Rectangle in scale coordinates. Points on the border
+               of the rectangle are considered as being inside.
+
+   \return Indices of the points in increasing order
+ */
+QVector< int > QwtPointIndex::pointsInRect( const QRectF& rect ) const
+{
+    QVector< int > indices;
+
+    qwtCollectPoints( m_data->nodes.constData(), 0, m_data->nodes.size(),
+        0, rect.normalized(), indices );
+
+    std::sort( indices.begin(), indices.end() );
+    return indices;
+}
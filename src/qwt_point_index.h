@@ -0,0 +1,63 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_POINT_INDEX_H
+#define QWT_POINT_INDEX_H
+
+#include "qwt_global.h"
+#include <qvector.h>
+
+class QwtScaleMap;
+class QPointF;
+class QRectF;
+template< typename T > class QwtSeriesData;
+
+/*!
+   \brief A spatial index for the points of a series
+
+   QwtPointIndex is a k-d tree of the points of a series, that allows
+   to find the closest point of a position or all points inside of
+   a rectangle in logarithmic time - instead of iterating over all points.
+
+   The tree is built in scale coordinates, so that it is independent from
+   the geometry of the canvas and the intervals of the scales. As only
+   the order of the coordinates matters, it can be used for any type of
+   monotonic scale transformation - f.e. logarithmic scales - too.
+
+   Building the index is of O(n * log(n)) and the index holds a copy of
+   the points. So it is only worth to build it, when the series is queried
+   more often than it is changed. Points with NaN coordinates are not indexed.
+
+   \sa QwtPlotCurve::setSpatialIndexEnabled()
+ */
+class QWT_EXPORT QwtPointIndex
+{
+  public:
+    QwtPointIndex();
+    ~QwtPointIndex();
+
+    void setSamples( const QwtSeriesData< QPointF >* );
+    void reset();
+
+    bool isNull() const;
+    int size() const;
+
+    int closestPoint( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+        const QPointF& pos, double* dist = NULL ) const;
+
+    QVector< int > pointsInRect( const QRectF& ) const;
+
+  private:
+    Q_DISABLE_COPY( QwtPointIndex )
+
+    class PrivateData;
+    PrivateData* m_data;
+};
+
+#endif
@@ -12,6 +12,9 @@
 #include "qwt_pixel_matrix.h"
 #include "qwt_series_data.h"
 #include "qwt_math.h"
+#include "qwt_color_map.h"
+#include "qwt_transform.h"
+#include "qwt_interval.h"
 
 #include <qpolygon.h>
 #include <qimage.h>
@@ -22,6 +25,8 @@
 #include <qfuture.h>
 #include <qtconcurrentrun.h>
 
+#include <algorithm>
+
 #if !defined( QT_NO_QFUTURE )
 #define QWT_USE_THREADS 1
 #endif
@@ -43,8 +48,118 @@ static inline double qwtRoundValueF( double value )
 #endif
 }
 
+namespace
+{
+    /*
+        Transformations of the samples into paint device coordinates,
+        so that the compiler can inline them into the mapping algorithms.
+     */
+
+    // the generic one: calling QwtSeriesData::sample() and QwtScaleMap::transform()
+    class QwtSeriesTransform
+    {
+      public:
+        inline QwtSeriesTransform(
+                const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+                const QwtSeriesData< QPointF >* series )
+            : m_xMap( xMap )
+            , m_yMap( yMap )
+            , m_series( series )
+        {
+        }
+
+        inline QPointF operator()( int index ) const
+        {
+            const QPointF sample = m_series->sample( index );
+            return QPointF( m_xMap.transform( sample.x() ),
+                m_yMap.transform( sample.y() ) );
+        }
+
+      private:
+        const QwtScaleMap& m_xMap;
+        const QwtScaleMap& m_yMap;
+        const QwtSeriesData< QPointF >* m_series;
+    };
+
+    // QwtScaleMap::transform() without checking for a QwtTransform
+    class QwtLinearMap
+    {
+      public:
+        inline explicit QwtLinearMap( const QwtScaleMap& map )
+            : m_p1( map.p1() )
+            , m_s1( map.s1() )
+            , m_cnv( 1.0 )
+        {
+            if ( map.s1() != map.s2() )
+                m_cnv = ( map.p2() - map.p1() ) / ( map.s2() - map.s1() );
+        }
+
+        inline double operator()( double value ) const
+        {
+            return m_p1 + ( value - m_s1 ) * m_cnv;
+        }
+
+      private:
+        double m_p1;
+        double m_s1;
+        double m_cnv;
+    };
+
+    // samples from QwtSeriesData::contiguousSamples()
+    class QwtLinearPointsTransform
+    {
+      public:
+        inline QwtLinearPointsTransform(
+                const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+                const QPointF* points )
+            : m_xMap( xMap )
+            , m_yMap( yMap )
+            , m_points( points )
+        {
+        }
+
+        inline QPointF operator()( int index ) const
+        {
+            const QPointF& sample = m_points[index];
+            return QPointF( m_xMap( sample.x() ), m_yMap( sample.y() ) );
+        }
+
+      private:
+        const QwtLinearMap m_xMap;
+        const QwtLinearMap m_yMap;
+        const QPointF* m_points;
+    };
+
+    // coordinates from QwtSeriesData::contiguousValues()
+    class QwtLinearValuesTransform
+    {
+      public:
+        inline QwtLinearValuesTransform(
+                const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+                const double* xValues, const double* yValues )
+            : m_xMap( xMap )
+            , m_yMap( yMap )
+            , m_xValues( xValues )
+            , m_yValues( yValues )
+        {
+        }
+
+        inline QPointF operator()( int index ) const
+        {
+            return QPointF( m_xMap( m_xValues[index] ), m_yMap( m_yValues[index] ) );
+        }
+
+      private:
+        const QwtLinearMap m_xMap;
+        const QwtLinearMap m_yMap;
+        const double* m_xValues;
+        const double* m_yValues;
+    };
+}
+
+template< class Transform >
 static Qt::Orientation qwtProbeOrientation(
-    const QwtSeriesData< QPointF >* series, int from, int to )
+    const Transform& transform, int from, int to )
 {
     if ( to - from < 20 )
     {
@@ -52,8 +167,10 @@ static Qt::Orientation qwtProbeOrientation(
         return Qt::Horizontal;
     }
 
-    const double x0 = series->sample( from ).x();
-    const double xn = series->sample( to ).x();
+    // as the maps are monotonic we can probe the mapped positions
+
+    const double x0 = transform( from ).x();
+    const double xn = transform( to ).x();
 
     if ( x0 == xn )
         return Qt::Vertical;
@@ -64,7 +181,7 @@ static Qt::Orientation qwtProbeOrientation(
     double x1 = x0;
     for ( int i = from + step; i < to; i += step )
     {
-        const double x2 = series->sample( i ).x();
+        const double x2 = transform( i ).x();
         if ( x2 != x1 )
         {
             if ( ( x2 > x1 ) != isIncreasing )
@@ -183,23 +300,21 @@ namespace
     };
 }
 
-template< class Polygon, class Point, class PolygonQuadrupel >
-static Polygon qwtMapPointsQuad( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series, int from, int to )
+template< class Polygon, class Point, class PolygonQuadrupel, class Transform >
+static Polygon qwtMapPointsQuad( const Transform& transform, int from, int to )
 {
-    const QPointF sample0 = series->sample( from );
+    const QPointF pos0 = transform( from );
 
     PolygonQuadrupel q;
-    q.start( qwtRoundValue( xMap.transform( sample0.x() ) ),
-        qwtRoundValue( yMap.transform( sample0.y() ) ) );
+    q.start( qwtRoundValue( pos0.x() ), qwtRoundValue( pos0.y() ) );
 
     Polygon polyline;
     for ( int i = from; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        const QPointF pos = transform( i );
 
-        const int x = qwtRoundValue( xMap.transform( sample.x() ) );
-        const int y = qwtRoundValue( yMap.transform( sample.y() ) );
+        const int x = qwtRoundValue( pos.x() );
+        const int y = qwtRoundValue( pos.y() );
 
         if ( !q.append( x, y ) )
         {
@@ -244,24 +359,23 @@ static Polygon qwtMapPointsQuad( const Polygon& polyline )
 }
 
 
-template< class Polygon, class Point >
-static Polygon qwtMapPointsQuad( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series, int from, int to )
+template< class Polygon, class Point, class Transform >
+static Polygon qwtMapPointsQuad( Qt::Orientation orientation,
+    const Transform& transform, int from, int to )
 {
     Polygon polyline;
     if ( from > to )
         return polyline;
 
     /*
-        probing some values, to decide if it is better
-        to start with x or y coordinates
+        the orientation has been probed before, to decide
+        if it is better to start with x or y coordinates
      */
-    const Qt::Orientation orientation = qwtProbeOrientation( series, from, to );
 
     if ( orientation == Qt::Horizontal )
     {
         polyline = qwtMapPointsQuad< Polygon, Point,
-            QwtPolygonQuadrupelY< Polygon, Point > >( xMap, yMap, series, from, to );
+            QwtPolygonQuadrupelY< Polygon, Point > >( transform, from, to );
 
         polyline = qwtMapPointsQuad< Polygon, Point,
             QwtPolygonQuadrupelX< Polygon, Point > >( polyline );
@@ -269,7 +383,7 @@ static Polygon qwtMapPointsQuad( const QwtScaleMap& xMap, const QwtScaleMap& yMa
     else
     {
         polyline = qwtMapPointsQuad< Polygon, Point,
-            QwtPolygonQuadrupelX< Polygon, Point > >( xMap, yMap, series, from, to );
+            QwtPolygonQuadrupelX< Polygon, Point > >( transform, from, to );
 
         polyline = qwtMapPointsQuad< Polygon, Point,
             QwtPolygonQuadrupelY< Polygon, Point > >( polyline );
@@ -342,11 +456,9 @@ struct QwtNoRoundF
 // mapping points without any filtering - beside checking
 // the bounding rectangle
 
-template< class Polygon, class Point, class Round >
+template< class Polygon, class Point, class Round, class Transform >
 static inline Polygon qwtToPoints(
-    const QRectF& boundingRect,
-    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series,
+    const QRectF& boundingRect, const Transform& transform,
     int from, int to, Round round )
 {
     Polygon polyline( to - from + 1 );
@@ -362,15 +474,12 @@ static inline Polygon qwtToPoints(
 
         for ( int i = from; i <= to; i++ )
         {
-            const QPointF sample = series->sample( i );
+            const QPointF pos = transform( i );
 
-            const double x = xMap.transform( sample.x() );
-            const double y = yMap.transform( sample.y() );
-
-            if ( boundingRect.contains( x, y ) )
+            if ( boundingRect.contains( pos.x(), pos.y() ) )
             {
-                points[ numPoints ].rx() = round( x );
-                points[ numPoints ].ry() = round( y );
+                points[ numPoints ].rx() = round( pos.x() );
+                points[ numPoints ].ry() = round( pos.y() );
 
                 numPoints++;
             }
@@ -381,17 +490,16 @@ static inline Polygon qwtToPoints(
     else
     {
         // simply iterating over all values
-        // without any filtering
+        // without any filtering. For contiguous
+        // samples and linear maps this is a tight loop,
+        // that can be vectorized by the compiler
 
         for ( int i = from; i <= to; i++ )
         {
-            const QPointF sample = series->sample( i );
-
-            const double x = xMap.transform( sample.x() );
-            const double y = yMap.transform( sample.y() );
+            const QPointF pos = transform( i );
 
-            points[ numPoints ].rx() = round( x );
-            points[ numPoints ].ry() = round( y );
+            points[ numPoints ].rx() = round( pos.x() );
+            points[ numPoints ].ry() = round( pos.y() );
 
             numPoints++;
         }
@@ -400,35 +508,30 @@ static inline Polygon qwtToPoints(
     return polyline;
 }
 
+template< class Transform >
 static inline QPolygon qwtToPointsI(
-    const QRectF& boundingRect,
-    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series,
+    const QRectF& boundingRect, const Transform& transform,
     int from, int to )
 {
     return qwtToPoints< QPolygon, QPoint >(
-        boundingRect, xMap, yMap, series, from, to, QwtRoundI() );
+        boundingRect, transform, from, to, QwtRoundI() );
 }
 
-template< class Round >
+template< class Round, class Transform >
 static inline QPolygonF qwtToPointsF(
-    const QRectF& boundingRect,
-    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series,
+    const QRectF& boundingRect, const Transform& transform,
     int from, int to, Round round )
 {
     return qwtToPoints< QPolygonF, QPointF >(
-        boundingRect, xMap, yMap, series, from, to, round );
+        boundingRect, transform, from, to, round );
 }
 
 // Mapping points with filtering out consecutive
 // points mapped to the same position
 
-template< class Polygon, class Point, class Round >
+template< class Polygon, class Point, class Round, class Transform >
 static inline Polygon qwtToPolylineFiltered(
-    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series,
-    int from, int to, Round round )
+    const Transform& transform, int from, int to, Round round )
 {
     // in curves with many points consecutive points
     // are often mapped to the same position. As this might
@@ -438,18 +541,17 @@ static inline Polygon qwtToPolylineFiltered(
     Polygon polyline( to - from + 1 );
     Point* points = polyline.data();
 
-    const QPointF sample0 = series->sample( from );
+    const QPointF pos0 = transform( from );
 
-    points[0].rx() = round( xMap.transform( sample0.x() ) );
-    points[0].ry() = round( yMap.transform( sample0.y() ) );
+    points[0].rx() = round( pos0.x() );
+    points[0].ry() = round( pos0.y() );
 
     int pos = 0;
     for ( int i = from + 1; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        const QPointF pos1 = transform( i );
 
-        const Point p( round( xMap.transform( sample.x() ) ),
-            round( yMap.transform( sample.y() ) ) );
+        const Point p( round( pos1.x() ), round( pos1.y() ) );
 
         if ( points[pos] != p )
             points[++pos] = p;
@@ -459,30 +561,26 @@ static inline Polygon qwtToPolylineFiltered(
     return polyline;
 }
 
+template< class Transform >
 static inline QPolygon qwtToPolylineFilteredI(
-    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series,
-    int from, int to )
+    const Transform& transform, int from, int to )
 {
     return qwtToPolylineFiltered< QPolygon, QPoint >(
-        xMap, yMap, series, from, to, QwtRoundI() );
+        transform, from, to, QwtRoundI() );
 }
 
-template< class Round >
+template< class Round, class Transform >
 static inline QPolygonF qwtToPolylineFilteredF(
-    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series,
-    int from, int to, Round round )
+    const Transform& transform, int from, int to, Round round )
 {
     return qwtToPolylineFiltered< QPolygonF, QPointF >(
-        xMap, yMap, series, from, to, round );
+        transform, from, to, round );
 }
 
-template< class Polygon, class Point >
+template< class Polygon, class Point, class Transform >
 static inline Polygon qwtToPointsFiltered(
-    const QRectF& boundingRect,
-    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series, int from, int to )
+    const QRectF& boundingRect, const Transform& transform,
+    int from, int to )
 {
     // F.e. in scatter plots ( no connecting lines ) we
     // can sort out all duplicates ( not only consecutive points )
@@ -495,10 +593,10 @@ static inline Polygon qwtToPointsFiltered(
     int numPoints = 0;
     for ( int i = from; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        const QPointF pos = transform( i );
 
-        const int x = qwtRoundValue( xMap.transform( sample.x() ) );
-        const int y = qwtRoundValue( yMap.transform( sample.y() ) );
+        const int x = qwtRoundValue( pos.x() );
+        const int y = qwtRoundValue( pos.y() );
 
         if ( pixelMatrix.testAndSetPixel( x, y, true ) == false )
         {
@@ -513,24 +611,372 @@ static inline Polygon qwtToPointsFiltered(
     return polygon;
 }
 
+template< class Transform >
 static inline QPolygon qwtToPointsFilteredI(
-    const QRectF& boundingRect,
-    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series, int from, int to )
+    const QRectF& boundingRect, const Transform& transform,
+    int from, int to )
 {
     return qwtToPointsFiltered< QPolygon, QPoint >(
-        boundingRect, xMap, yMap, series, from, to );
+        boundingRect, transform, from, to );
 }
 
+template< class Transform >
 static inline QPolygonF qwtToPointsFilteredF(
-    const QRectF& boundingRect,
-    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series, int from, int to )
+    const QRectF& boundingRect, const Transform& transform,
+    int from, int to )
 {
     return qwtToPointsFiltered< QPolygonF, QPointF >(
-        boundingRect, xMap, yMap, series, from, to );
+        boundingRect, transform, from, to );
+}
+
+// the algorithms behind the public methods of QwtPointMapper
+
+template< class Transform >
+static QPolygonF qwtMapToPolygonF( QwtPointMapper::TransformationFlags flags,
+    Qt::Orientation orientation, const Transform& transform, int from, int to )
+{
+    QPolygonF polyline;
+
+    if ( flags & QwtPointMapper::RoundPoints )
+    {
+        if ( flags & QwtPointMapper::WeedOutIntermediatePoints )
+        {
+            polyline = qwtMapPointsQuad< QPolygonF, QPointF >(
+                orientation, transform, from, to );
+        }
+        else if ( flags & QwtPointMapper::WeedOutPoints )
+        {
+            polyline = qwtToPolylineFilteredF(
+                transform, from, to, QwtRoundF() );
+        }
+        else
+        {
+            polyline = qwtToPointsF( qwtInvalidRect,
+                transform, from, to, QwtRoundF() );
+        }
+    }
+    else
+    {
+        if ( flags & QwtPointMapper::WeedOutPoints )
+        {
+            polyline = qwtToPolylineFilteredF(
+                transform, from, to, QwtNoRoundF() );
+        }
+        else
+        {
+            polyline = qwtToPointsF( qwtInvalidRect,
+                transform, from, to, QwtNoRoundF() );
+        }
+    }
+
+    return polyline;
+}
+
+template< class Transform >
+static QPolygon qwtMapToPolygon( QwtPointMapper::TransformationFlags flags,
+    Qt::Orientation orientation, const Transform& transform, int from, int to )
+{
+    QPolygon polyline;
+
+    if ( flags & QwtPointMapper::WeedOutIntermediatePoints )
+    {
+        // TODO WeedOutIntermediatePointsY ...
+        polyline = qwtMapPointsQuad< QPolygon, QPoint >(
+            orientation, transform, from, to );
+    }
+    else if ( flags & QwtPointMapper::WeedOutPoints )
+    {
+        polyline = qwtToPolylineFilteredI( transform, from, to );
+    }
+    else
+    {
+        polyline = qwtToPointsI( qwtInvalidRect, transform, from, to );
+    }
+
+    return polyline;
+}
+
+template< class Transform >
+static QPolygonF qwtMapToPointsF( QwtPointMapper::TransformationFlags flags,
+    const QRectF& boundingRect, const Transform& transform, int from, int to )
+{
+    QPolygonF points;
+
+    if ( flags & QwtPointMapper::WeedOutPoints )
+    {
+        if ( flags & QwtPointMapper::RoundPoints )
+        {
+            if ( boundingRect.isValid() )
+            {
+                points = qwtToPointsFilteredF( boundingRect,
+                    transform, from, to );
+            }
+            else
+            {
+                // without a bounding rectangle all we can
+                // do is to filter out duplicates of
+                // consecutive points
+
+                points = qwtToPolylineFilteredF(
+                    transform, from, to, QwtRoundF() );
+            }
+        }
+        else
+        {
+            // when rounding is not allowed we can't use
+            // qwtToPointsFilteredF
+
+            points = qwtToPolylineFilteredF(
+                transform, from, to, QwtNoRoundF() );
+        }
+    }
+    else
+    {
+        if ( flags & QwtPointMapper::RoundPoints )
+        {
+            points = qwtToPointsF( boundingRect,
+                transform, from, to, QwtRoundF() );
+        }
+        else
+        {
+            points = qwtToPointsF( boundingRect,
+                transform, from, to, QwtNoRoundF() );
+        }
+    }
+
+    return points;
+}
+
+template< class Transform >
+static QPolygon qwtMapToPoints( QwtPointMapper::TransformationFlags flags,
+    const QRectF& boundingRect, const Transform& transform, int from, int to )
+{
+    QPolygon points;
+
+    if ( flags & QwtPointMapper::WeedOutPoints )
+    {
+        if ( boundingRect.isValid() )
+        {
+            points = qwtToPointsFilteredI( boundingRect,
+                transform, from, to );
+        }
+        else
+        {
+            // when we don't have the bounding rectangle all
+            // we can do is to filter out consecutive duplicates
+
+            points = qwtToPolylineFilteredI( transform, from, to );
+        }
+    }
+    else
+    {
+        points = qwtToPointsI( boundingRect, transform, from, to );
+    }
+
+    return points;
+}
+
+// Helper class to work around the 5 parameters
+// limitation of QtConcurrent::run()
+template< class Polygon, class Transform >
+class QwtPolylineCommand
+{
+  public:
+    typedef Polygon ( *MapFunction )( QwtPointMapper::TransformationFlags,
+        Qt::Orientation, const Transform&, int, int );
+
+    MapFunction map;
+    QwtPointMapper::TransformationFlags flags;
+    Qt::Orientation orientation;
+    const Transform* transform;
+    int from;
+    int to;
+};
+
+template< class Polygon, class Transform >
+static Polygon qwtMapPolylineChunk(
+    const QwtPolylineCommand< Polygon, Transform >& command )
+{
+    return command.map( command.flags, command.orientation,
+        *command.transform, command.from, command.to );
+}
+
+template< class Polygon >
+static void qwtAppendChunk( Polygon& polyline,
+    const Polygon& chunk, bool isFiltered )
+{
+    int index0 = 0;
+
+    if ( isFiltered && !polyline.isEmpty() && !chunk.isEmpty() )
+    {
+        // the filter did not see the last point of the previous chunk
+        if ( chunk.first() == polyline.last() )
+            index0 = 1;
+    }
+
+    const int numPoints = chunk.size() - index0;
+    if ( numPoints > 0 )
+    {
+        const int size0 = polyline.size();
+        polyline.resize( size0 + numPoints );
+
+        std::copy( chunk.constData() + index0,
+            chunk.constData() + chunk.size(), polyline.data() + size0 );
+    }
+}
+
+/*
+    Mapping the interval [from, to] in chunks, that are processed
+    in parallel. The results are joined at the borders of the chunks,
+    so that the polyline is the same as when being mapped in one go -
+    beside the WeedOutIntermediatePoints algorithm, where the joined
+    polyline is reduced once more for the runs of points, that have been
+    split at the borders.
+ */
+template< class Polygon, class Point, class Transform >
+static Polygon qwtMapPolyline( QwtPolylineCommand< Polygon, Transform > command,
+    bool isQuad, uint numThreads )
+{
+    if ( isQuad )
+    {
+        command.orientation = qwtProbeOrientation(
+            *command.transform, command.from, command.to );
+    }
+
+#if QWT_USE_THREADS
+    // not worth the overhead of a thread for less points
+    const int minChunkSize = 10000;
+
+    const int numPoints = command.to - command.from + 1;
+
+    int numChunks = numThreads;
+    if ( numChunks == 0 )
+        numChunks = QThread::idealThreadCount();
+
+    numChunks = qMin( numChunks, numPoints / minChunkSize );
+
+    if ( numChunks > 1 )
+    {
+        const int chunkSize = numPoints / numChunks;
+        const int to = command.to;
+
+        QList< QFuture< Polygon > > futures;
+        for ( int i = 0; i < numChunks - 1; i++ )
+        {
+            command.to = command.from + chunkSize - 1;
+
+            futures += QtConcurrent::run(
+                &qwtMapPolylineChunk< Polygon, Transform >, command );
+
+            command.from = command.to + 1;
+        }
+
+        command.to = to;
+        const Polygon lastChunk = qwtMapPolylineChunk( command );
+
+        const bool isFiltered = isQuad ||
+            ( command.flags & QwtPointMapper::WeedOutPoints );
+
+        Polygon polyline;
+        for ( int i = 0; i < futures.size(); i++ )
+            qwtAppendChunk( polyline, futures[i].result(), isFiltered );
+
+        qwtAppendChunk( polyline, lastChunk, isFiltered );
+
+        if ( isQuad )
+        {
+            typedef QwtPolygonQuadrupelX< Polygon, Point > QuadrupelX;
+            typedef QwtPolygonQuadrupelY< Polygon, Point > QuadrupelY;
+
+            if ( command.orientation == Qt::Horizontal )
+            {
+                polyline = qwtMapPointsQuad< Polygon, Point, QuadrupelY >( polyline );
+                polyline = qwtMapPointsQuad< Polygon, Point, QuadrupelX >( polyline );
+            }
+            else
+            {
+                polyline = qwtMapPointsQuad< Polygon, Point, QuadrupelX >( polyline );
+                polyline = qwtMapPointsQuad< Polygon, Point, QuadrupelY >( polyline );
+            }
+        }
+
+        return polyline;
+    }
+#else
+    Q_UNUSED( numThreads )
+#endif
+
+    return qwtMapPolylineChunk( command );
+}
+
+template< class Transform >
+static QPolygonF qwtMapPolylineF( QwtPointMapper::TransformationFlags flags,
+    const Transform& transform, int from, int to, uint numThreads )
+{
+    QwtPolylineCommand< QPolygonF, Transform > command;
+    command.map = &qwtMapToPolygonF< Transform >;
+    command.flags = flags;
+    command.orientation = Qt::Horizontal;
+    command.transform = &transform;
+    command.from = from;
+    command.to = to;
+
+    const bool isQuad = ( flags & QwtPointMapper::RoundPoints )
+        && ( flags & QwtPointMapper::WeedOutIntermediatePoints );
+
+    return qwtMapPolyline< QPolygonF, QPointF >( command, isQuad, numThreads );
+}
+
+template< class Transform >
+static QPolygon qwtMapPolylineI( QwtPointMapper::TransformationFlags flags,
+    const Transform& transform, int from, int to, uint numThreads )
+{
+    QwtPolylineCommand< QPolygon, Transform > command;
+    command.map = &qwtMapToPolygon< Transform >;
+    command.flags = flags;
+    command.orientation = Qt::Horizontal;
+    command.transform = &transform;
+    command.from = from;
+    command.to = to;
+
+    const bool isQuad = flags & QwtPointMapper::WeedOutIntermediatePoints;
+
+    return qwtMapPolyline< QPolygon, QPoint >( command, isQuad, numThreads );
 }
 
+/*
+    Deciding once for all points of a series, which of the transformations
+    can be used: when the samples are in contiguous memory and
+    both maps are linear we can avoid calling virtual methods for
+    each point.
+ */
+class QwtSeriesAccess
+{
+  public:
+    QwtSeriesAccess( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+            const QwtSeriesData< QPointF >* series )
+        : points( NULL )
+        , xValues( NULL )
+        , yValues( NULL )
+    {
+        if ( xMap.transformation() == NULL && yMap.transformation() == NULL )
+        {
+            points = series->contiguousSamples();
+            if ( points == NULL )
+            {
+                if ( !series->contiguousValues( &xValues, &yValues ) )
+                {
+                    xValues = yValues = NULL;
+                }
+            }
+        }
+    }
+
+    const QPointF* points;
+    const double* xValues;
+    const double* yValues;
+};
+
 class QwtPointMapper::PrivateData
 {
   public:
@@ -641,48 +1087,34 @@ QRectF QwtPointMapper::boundingRect() const
    \param series Series of points to be mapped
    \param from Index of the first point to be painted
    \param to Index of the last point to be painted
-
+   \param numThreads Number of threads to be used for mapping.
+                   If numThreads is set to 0, the system specific
+                   ideal thread count is used.
+
    \return Translated polygon
  */
 QPolygonF QwtPointMapper::toPolygonF(
     const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series, int from, int to ) const
+    const QwtSeriesData< QPointF >* series, int from, int to,
+    uint numThreads ) const
 {
-    QPolygonF polyline;
+    const QwtSeriesAccess access( xMap, yMap, series );
 
-    if ( m_data->flags & RoundPoints )
+    if ( access.points )
     {
-        if ( m_data->flags & WeedOutIntermediatePoints )
-        {
-            polyline = qwtMapPointsQuad< QPolygonF, QPointF >(
-                xMap, yMap, series, from, to );
-        }
-        else if ( m_data->flags & WeedOutPoints )
-        {
-            polyline = qwtToPolylineFilteredF(
-                xMap, yMap, series, from, to, QwtRoundF() );
-        }
-        else
-        {
-            polyline = qwtToPointsF( qwtInvalidRect,
-                xMap, yMap, series, from, to, QwtRoundF() );
-        }
+        return qwtMapPolylineF( m_data->flags,
+            QwtLinearPointsTransform( xMap, yMap, access.points ),
+            from, to, numThreads );
     }
-    else
+
+    if ( access.xValues )
     {
-        if ( m_data->flags & WeedOutPoints )
-        {
-            polyline = qwtToPolylineFilteredF(
-                xMap, yMap, series, from, to, QwtNoRoundF() );
-        }
-        else
-        {
-            polyline = qwtToPointsF( qwtInvalidRect,
-                xMap, yMap, series, from, to, QwtNoRoundF() );
-        }
+        return qwtMapPolylineF( m_data->flags, QwtLinearValuesTransform(
+            xMap, yMap, access.xValues, access.yValues ), from, to, numThreads );
     }
 
-    return polyline;
+    return qwtMapPolylineF( m_data->flags,
+        QwtSeriesTransform( xMap, yMap, series ), from, to, numThreads );
 }
 
 /*!
@@ -696,33 +1128,34 @@ QPolygonF QwtPointMapper::toPolygonF(
    \param series Series of points to be mapped
    \param from Index of the first point to be painted
    \param to Index of the last point to be painted
+   \param numThreads Number of threads to be used for mapping.
+                   If numThreads is set to 0, the system specific
+                   ideal thread count is used.
 
    \return Translated polygon
  */
 QPolygon QwtPointMapper::toPolygon(
     const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-    const QwtSeriesData< QPointF >* series, int from, int to ) const
+    const QwtSeriesData< QPointF >* series, int from, int to,
+    uint numThreads ) const
 {
-    QPolygon polyline;
+    const QwtSeriesAccess access( xMap, yMap, series );
 
-    if ( m_data->flags & WeedOutIntermediatePoints )
-    {
-        // TODO WeedOutIntermediatePointsY ...
-        polyline = qwtMapPointsQuad< QPolygon, QPoint >(
-            xMap, yMap, series, from, to );
-    }
-    else if ( m_data->flags & WeedOutPoints )
+    if ( access.points )
     {
-        polyline = qwtToPolylineFilteredI(
-            xMap, yMap, series, from, to );
+        return qwtMapPolylineI( m_data->flags,
+            QwtLinearPointsTransform( xMap, yMap, access.points ),
+            from, to, numThreads );
     }
-    else
+
+    if ( access.xValues )
     {
-        polyline = qwtToPointsI(
-            qwtInvalidRect, xMap, yMap, series, from, to );
+        return qwtMapPolylineI( m_data->flags, QwtLinearValuesTransform(
+            xMap, yMap, access.xValues, access.yValues ), from, to, numThreads );
     }
 
-    return polyline;
+    return qwtMapPolylineI( m_data->flags,
+        QwtSeriesTransform( xMap, yMap, series ), from, to, numThreads );
 }
 
 /*!
@@ -760,51 +1193,23 @@ QPolygonF QwtPointMapper::toPointsF(
     const QwtScaleMap& xMap, const QwtScaleMap& yMap,
     const QwtSeriesData< QPointF >* series, int from, int to ) const
 {
-    QPolygonF points;
+    const QwtSeriesAccess access( xMap, yMap, series );
 
-    if ( m_data->flags & WeedOutPoints )
+    if ( access.points )
     {
-        if ( m_data->flags & RoundPoints )
-        {
-            if ( m_data->boundingRect.isValid() )
-            {
-                points = qwtToPointsFilteredF( m_data->boundingRect,
-                    xMap, yMap, series, from, to );
-            }
-            else
-            {
-                // without a bounding rectangle all we can
-                // do is to filter out duplicates of
-                // consecutive points
-
-                points = qwtToPolylineFilteredF(
-                    xMap, yMap, series, from, to, QwtRoundF() );
-            }
-        }
-        else
-        {
-            // when rounding is not allowed we can't use
-            // qwtToPointsFilteredF
-
-            points = qwtToPolylineFilteredF(
-                xMap, yMap, series, from, to, QwtNoRoundF() );
-        }
+        return qwtMapToPointsF( m_data->flags, m_data->boundingRect,
+            QwtLinearPointsTransform( xMap, yMap, access.points ), from, to );
     }
-    else
+
+    if ( access.xValues )
     {
-        if ( m_data->flags & RoundPoints )
-        {
-            points = qwtToPointsF( m_data->boundingRect,
-                xMap, yMap, series, from, to, QwtRoundF() );
-        }
-        else
-        {
-            points = qwtToPointsF( m_data->boundingRect,
-                xMap, yMap, series, from, to, QwtNoRoundF() );
-        }
+        return qwtMapToPointsF( m_data->flags, m_data->boundingRect,
+            QwtLinearValuesTransform( xMap, yMap, access.xValues, access.yValues ),
+            from, to );
     }
 
-    return points;
+    return qwtMapToPointsF( m_data->flags, m_data->boundingRect,
+        QwtSeriesTransform( xMap, yMap, series ), from, to );
 }
 
 /*!
@@ -834,31 +1239,23 @@ QPolygon QwtPointMapper::toPoints(
     const QwtScaleMap& xMap, const QwtScaleMap& yMap,
     const QwtSeriesData< QPointF >* series, int from, int to ) const
 {
-    QPolygon points;
+    const QwtSeriesAccess access( xMap, yMap, series );
 
-    if ( m_data->flags & WeedOutPoints )
+    if ( access.points )
     {
-        if ( m_data->boundingRect.isValid() )
-        {
-            points = qwtToPointsFilteredI( m_data->boundingRect,
-                xMap, yMap, series, from, to );
-        }
-        else
-        {
-            // when we don't have the bounding rectangle all
-            // we can do is to filter out consecutive duplicates
-
-            points = qwtToPolylineFilteredI(
-                xMap, yMap, series, from, to );
-        }
+        return qwtMapToPoints( m_data->flags, m_data->boundingRect,
+            QwtLinearPointsTransform( xMap, yMap, access.points ), from, to );
     }
-    else
+
+    if ( access.xValues )
     {
-        points = qwtToPointsI(
-            m_data->boundingRect, xMap, yMap, series, from, to );
+        return qwtMapToPoints( m_data->flags, m_data->boundingRect,
+            QwtLinearValuesTransform( xMap, yMap, access.xValues, access.yValues ),
+            from, to );
     }
 
-    return points;
+    return qwtMapToPoints( m_data->flags, m_data->boundingRect,
+        QwtSeriesTransform( xMap, yMap, series ), from, to );
 }
 
 
@@ -967,3 +1364,578 @@ QImage QwtPointMapper::toImage(
 
     return image;
 }
+
+// Helper class to work around the 5 parameters
+// limitation of QtConcurrent::run()
+class QwtSpritesCommand
+{
+  public:
+    const QwtSeriesData< QPointF >* series;
+    int from;
+    int to;
+
+    // geometry of the image in paint device coordinates
+    QRect rect;
+
+    QSize spriteSize;
+    QPoint hotSpot;
+
+    int numBands;
+    int bandHeight;
+};
+
+// the top left positions of the sprites, sorted by the bands they overlap
+typedef QVector< QVector< QPoint > > QwtSpritePositions;
+
+template< class Transform >
+static QwtSpritePositions qwtMapSprites(
+    const Transform& transform, const QwtSpritesCommand& command )
+{
+    QwtSpritePositions positions( command.numBands );
+
+    const int w = command.rect.width();
+    const int h = command.rect.height();
+    const int sw = command.spriteSize.width();
+    const int sh = command.spriteSize.height();
+
+    for ( int i = command.from; i <= command.to; i++ )
+    {
+        const QPointF pos = transform( i );
+
+        const double x = pos.x() - command.rect.left();
+        const double y = pos.y() - command.rect.top();
+
+        // also sorting out NaNs
+        if ( !( x > -sw - 1 && x < w + sw + 1 && y > -sh - 1 && y < h + sh + 1 ) )
+            continue;
+
+        const int left = static_cast< int >( std::floor( x + 0.5 ) ) - command.hotSpot.x();
+        const int top = static_cast< int >( std::floor( y + 0.5 ) ) - command.hotSpot.y();
+
+        if ( left >= w || top >= h || left + sw <= 0 || top + sh <= 0 )
+            continue;
+
+        const int band1 = qMax( top, 0 ) / command.bandHeight;
+        const int band2 = qMin( top + sh - 1, h - 1 ) / command.bandHeight;
+
+        for ( int band = band1; band <= band2; band++ )
+            positions[band] += QPoint( left, top );
+    }
+
+    return positions;
+}
+
+static QwtSpritePositions qwtMapSpritesChunk(
+    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+    const QwtSpritesCommand& command )
+{
+    const QwtSeriesAccess access( xMap, yMap, command.series );
+
+    if ( access.points )
+    {
+        return qwtMapSprites(
+            QwtLinearPointsTransform( xMap, yMap, access.points ), command );
+    }
+
+    if ( access.xValues )
+    {
+        return qwtMapSprites( QwtLinearValuesTransform(
+            xMap, yMap, access.xValues, access.yValues ), command );
+    }
+
+    return qwtMapSprites(
+        QwtSeriesTransform( xMap, yMap, command.series ), command );
+}
+
+// source over composition of premultiplied pixels
+static inline QRgb qwtBlendPixel( QRgb src, QRgb dst )
+{
+    const uint alpha = 255 - qAlpha( src );
+    if ( alpha == 0 )
+        return src;
+
+    uint rb = ( dst & 0xff00ff ) * alpha;
+    rb = ( ( rb + ( ( rb >> 8 ) & 0xff00ff ) + 0x800080 ) >> 8 ) & 0xff00ff;
+
+    uint ag = ( ( dst >> 8 ) & 0xff00ff ) * alpha;
+    ag = ( ag + ( ( ag >> 8 ) & 0xff00ff ) + 0x800080 ) & 0xff00ff00;
+
+    return src + ( rb | ag );
+}
+
+static void qwtBlendSprites( const QwtSpritesCommand& command,
+    const QList< QwtSpritePositions >* chunks, int band,
+    const QImage* sprite, QImage* image )
+{
+    const int y1 = band * command.bandHeight;
+    const int y2 = qMin( y1 + command.bandHeight, image->height() );
+
+    const int w = image->width();
+    const int sw = sprite->width();
+    const int sh = sprite->height();
+
+    // the chunks are in the order of the samples
+    for ( int i = 0; i < chunks->size(); i++ )
+    {
+        const QVector< QPoint >& positions = ( *chunks )[i][band];
+
+        for ( int j = 0; j < positions.size(); j++ )
+        {
+            const QPoint& pos = positions[j];
+
+            const int top = qMax( pos.y(), y1 );
+            const int bottom = qMin( pos.y() + sh, y2 );
+            const int left = qMax( pos.x(), 0 );
+            const int right = qMin( pos.x() + sw, w );
+
+            for ( int y = top; y < bottom; y++ )
+            {
+                const QRgb* from = reinterpret_cast< const QRgb* >(
+                    sprite->constScanLine( y - pos.y() ) );
+
+                QRgb* to = reinterpret_cast< QRgb* >( image->scanLine( y ) );
+
+                for ( int x = left; x < right; x++ )
+                {
+                    const QRgb rgb = from[ x - pos.x() ];
+                    if ( rgb != 0u )
+                        to[x] = qwtBlendPixel( rgb, to[x] );
+                }
+            }
+        }
+    }
+}
+
+/*!
+   \brief Translate a series into a QImage displaying a symbol at each point
+
+   The points are mapped in parallel chunks, and the sprite is composed
+   ( QPainter::CompositionMode_SourceOver ) into horizontal bands of
+   the image, where each band is processed by a different thread.
+   As the bands do not overlap no synchronization is needed and
+   the sprites are composed in the order of the samples.
+
+   \param xMap x map
+   \param yMap y map
+   \param series Series of points to be mapped
+   \param from Index of the first point to be painted
+   \param to Index of the last point to be painted
+   \param sprite Prerendered image of the symbol. It will be converted
+                 to QImage::Format_ARGB32_Premultiplied if necessary.
+   \param hotSpot Position of the sprite, that is aligned to the mapped point
+   \param numThreads Number of threads to be used for rendering.
+                   If numThreads is set to 0, the system specific
+                   ideal thread count is used.
+
+   \return Image of the size of boundingRect().toAlignedRect()
+           in QImage::Format_ARGB32_Premultiplied
+
+   \sa QwtPlotCurve::SymbolImageBuffer
+ */
+QImage QwtPointMapper::toImage(
+    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+    const QwtSeriesData< QPointF >* series, int from, int to,
+    const QImage& sprite, const QPoint& hotSpot, uint numThreads ) const
+{
+#if QWT_USE_THREADS
+    if ( numThreads == 0 )
+        numThreads = QThread::idealThreadCount();
+
+    if ( numThreads <= 0 )
+        numThreads = 1;
+#else
+    Q_UNUSED( numThreads )
+#endif
+
+    const QRect rect = m_data->boundingRect.toAlignedRect();
+
+    QImage image( rect.size(), QImage::Format_ARGB32_Premultiplied );
+    image.fill( 0u );
+
+    if ( rect.isEmpty() || sprite.isNull() || from > to )
+        return image;
+
+    const QImage spriteImage =
+        sprite.convertToFormat( QImage::Format_ARGB32_Premultiplied );
+
+    QwtSpritesCommand command;
+    command.series = series;
+    command.rect = rect;
+    command.spriteSize = spriteImage.size();
+    command.hotSpot = hotSpot;
+
+#if QWT_USE_THREADS
+    const int numBands = qMin( int( numThreads ), rect.height() );
+#else
+    const int numBands = 1;
+#endif
+
+    command.numBands = numBands;
+    command.bandHeight = ( rect.height() + numBands - 1 ) / numBands;
+
+    QList< QwtSpritePositions > chunks;
+
+#if QWT_USE_THREADS
+    const int numPoints = ( to - from + 1 ) / int( numThreads );
+
+    QList< QFuture< QwtSpritePositions > > futures;
+    for ( uint i = 0; i < numThreads; i++ )
+    {
+        command.from = from + i * numPoints;
+        command.to = ( i == numThreads - 1 ) ? to : command.from + numPoints - 1;
+
+        if ( i == numThreads - 1 )
+        {
+            const QwtSpritePositions positions =
+                qwtMapSpritesChunk( xMap, yMap, command );
+
+            for ( int j = 0; j < futures.size(); j++ )
+                chunks += futures[j].result();
+
+            chunks += positions;
+        }
+        else
+        {
+            futures += QtConcurrent::run( &qwtMapSpritesChunk,
+                xMap, yMap, command );
+        }
+    }
+
+    QList< QFuture< void > > bandFutures;
+    for ( int band = 0; band < numBands; band++ )
+    {
+        if ( band == numBands - 1 )
+        {
+            qwtBlendSprites( command, &chunks, band, &spriteImage, &image );
+        }
+        else
+        {
+            bandFutures += QtConcurrent::run( &qwtBlendSprites,
+                command, &chunks, band, &spriteImage, &image );
+        }
+    }
+    for ( int i = 0; i < bandFutures.size(); i++ )
+        bandFutures[i].waitForFinished();
+#else
+    command.from = from;
+    command.to = to;
+
+    chunks += qwtMapSpritesChunk( xMap, yMap, command );
+    qwtBlendSprites( command, &chunks, 0, &spriteImage, &image );
+#endif
+
+    return image;
+}
+
+// Helper class to work around the 5 parameters
+// limitation of QtConcurrent::run()
+class QwtDensityCommand
+{
+  public:
+    const QwtSeriesData< QPointF >* series;
+    int from;
+    int to;
+
+    // geometry of the image in paint device coordinates
+    QRect rect;
+};
+
+template< class Transform >
+static void qwtCountHits( const Transform& transform,
+    const QwtDensityCommand& command, quint32* counts )
+{
+    const int w = command.rect.width();
+    const int h = command.rect.height();
+
+    const double x0 = command.rect.left();
+    const double y0 = command.rect.top();
+
+    for ( int i = command.from; i <= command.to; i++ )
+    {
+        const QPointF pos = transform( i );
+
+        const double x = std::floor( pos.x() - x0 + 0.5 );
+        const double y = std::floor( pos.y() - y0 + 0.5 );
+
+        // also sorting out NaNs
+        if ( x >= 0.0 && x < w && y >= 0.0 && y < h )
+            counts[ int( y ) * w + int( x ) ]++;
+    }
+}
+
+static void qwtCountHitsChunk(
+    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+    const QwtDensityCommand& command, quint32* counts )
+{
+    const QwtSeriesAccess access( xMap, yMap, command.series );
+
+    if ( access.points )
+    {
+        qwtCountHits( QwtLinearPointsTransform( xMap, yMap, access.points ),
+            command, counts );
+    }
+    else if ( access.xValues )
+    {
+        qwtCountHits( QwtLinearValuesTransform(
+            xMap, yMap, access.xValues, access.yValues ), command, counts );
+    }
+    else
+    {
+        qwtCountHits( QwtSeriesTransform( xMap, yMap, command.series ),
+            command, counts );
+    }
+}
+
+// adding the counts of all buffers to the first one
+static quint32 qwtReduceHits( const QVector< quint32* >* buffers,
+    int from, int to )
+{
+    quint32* counts = ( *buffers )[0];
+
+    for ( int i = 1; i < buffers->size(); i++ )
+    {
+        const quint32* c = ( *buffers )[i];
+        for ( int j = from; j < to; j++ )
+            counts[j] += c[j];
+    }
+
+    quint32 maxCount = 0;
+    for ( int j = from; j < to; j++ )
+        maxCount = qMax( maxCount, counts[j] );
+
+    return maxCount;
+}
+
+namespace
+{
+    // mapping the counts of the density image into colors
+    class QwtDensityColors
+    {
+      public:
+        QwtDensityColors( const QwtColorMap* colorMap,
+                const QwtTransform* transform, quint32 maxCount )
+            : m_colorMap( colorMap )
+            , m_transform( transform )
+        {
+            m_interval.setInterval( value( 1 ), value( qMax( maxCount, 1u ) ) );
+
+            /*
+                When all pixels have the same count - f.e. sparse points
+                or zoomed in - the interval has no width ( [0, 0] for a
+                QwtLogTransform ). Then all hits are mapped to the top color
+                instead of being transparent.
+             */
+            m_topColor = m_colorMap->rgb( QwtInterval( 0.0, 1.0 ), 1.0 );
+            m_isDegenerated = !( m_interval.width() > 0.0 );
+
+            // a lookup table for all counts - unless there are too many
+
+            m_table.resize( int( qMin( maxCount, 65535u ) ) + 1 );
+            m_table[0] = 0u;
+
+            for ( int i = 1; i < m_table.size(); i++ )
+                m_table[i] = color( i );
+        }
+
+        inline QRgb rgb( quint32 count ) const
+        {
+            if ( count < quint32( m_table.size() ) )
+                return m_table.constData()[count];
+
+            return color( count );
+        }
+
+      private:
+        inline double value( quint32 count ) const
+        {
+            return m_transform ? m_transform->transform( count ) : double( count );
+        }
+
+        inline QRgb color( quint32 count ) const
+        {
+            if ( m_isDegenerated )
+                return m_topColor;
+
+            return m_colorMap->rgb( m_interval, value( count ) );
+        }
+
+        const QwtColorMap* m_colorMap;
+        const QwtTransform* m_transform;
+
+        QwtInterval m_interval;
+        bool m_isDegenerated;
+        QRgb m_topColor;
+
+        QVector< QRgb > m_table;
+    };
+}
+
+static void qwtColorizeHits( const quint32* counts, int from, int to,
+    const QwtDensityColors* colors, QImage* image )
+{
+    QRgb* bits = reinterpret_cast< QRgb* >( image->bits() );
+
+    for ( int i = from; i < to; i++ )
+        bits[i] = colors->rgb( counts[i] );
+}
+
+/*!
+   \brief Translate a series into a density image
+
+   The number of points, that are mapped to each pixel, is counted.
+   The counts are translated into colors, where the interval of the
+   color map is [ 1, maximum count ] - or the transformed interval,
+   when a transformation is given. Pixels without any point
+   are transparent. When all pixels with points have the same count,
+   they are painted in the color for the maximum of the color map.
+
+   The series is split into chunks, that are counted into separate
+   buffers by numThreads threads. Then the buffers are
+   reduced and colorized in parallel bands. As each buffer has a counter
+   for each pixel, the number of threads is reduced for series with
+   less points than numThreads * pixels, and the buffers are limited
+   to 64MB in total.
+
+   \param xMap x map
+   \param yMap y map
+   \param series Series of points to be mapped
+   \param from Index of the first point to be painted
+   \param to Index of the last point to be painted
+   \param colorMap Color map translating the counts into colors
+   \param transform Transformation of the counts, f.e. a QwtLogTransform.
+                    NULL means linear.
+   \param numThreads Number of threads to be used for rendering.
+                   If numThreads is set to 0, the system specific
+                   ideal thread count is used.
+
+   \return Image of the size of boundingRect().toAlignedRect()
+           in QImage::Format_ARGB32
+
+   \sa QwtPlotCurve::setDensityColorMap()
+ */
+QImage QwtPointMapper::toDensityImage(
+    const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+    const QwtSeriesData< QPointF >* series, int from, int to,
+    const QwtColorMap& colorMap, const QwtTransform* transform,
+    uint numThreads ) const
+{
+#if QWT_USE_THREADS
+    if ( numThreads == 0 )
+        numThreads = QThread::idealThreadCount();
+
+    if ( numThreads <= 0 )
+        numThreads = 1;
+#else
+    numThreads = 1;
+#endif
+
+    const QRect rect = m_data->boundingRect.toAlignedRect();
+
+    QImage image( rect.size(), QImage::Format_ARGB32 );
+    image.fill( 0u );
+
+    if ( rect.isEmpty() || from > to )
+        return image;
+
+    const int numPixels = rect.width() * rect.height();
+
+#if QWT_USE_THREADS
+    /*
+        Each thread needs its own buffer of counters, so that no locking
+        is needed. This is only worth it, when there are many more points
+        than pixels, and the total size of the buffers is limited.
+     */
+    const qint64 maxCounters = 16 * 1024 * 1024; // 64MB
+    const qint64 numSamples = qint64( to ) - from + 1;
+
+    const qint64 maxBuffers = qMin( numSamples / numPixels, maxCounters / numPixels );
+    numThreads = uint( qBound( qint64( 1 ), qint64( numThreads ), maxBuffers ) );
+#endif
+
+    QVector< quint32 > hits( int( qint64( numThreads ) * numPixels ), 0u );
+
+    QVector< quint32* > buffers( numThreads );
+    for ( uint i = 0; i < numThreads; i++ )
+        buffers[i] = hits.data() + i * numPixels;
+
+    QwtDensityCommand command;
+    command.series = series;
+    command.rect = rect;
+
+#if QWT_USE_THREADS
+    const int numPoints = ( to - from + 1 ) / int( numThreads );
+
+    QList< QFuture< void > > futures;
+    for ( uint i = 0; i < numThreads; i++ )
+    {
+        command.from = from + i * numPoints;
+        command.to = ( i == numThreads - 1 ) ? to : command.from + numPoints - 1;
+
+        if ( i == numThreads - 1 )
+        {
+            qwtCountHitsChunk( xMap, yMap, command, buffers[i] );
+        }
+        else
+        {
+            futures += QtConcurrent::run( &qwtCountHitsChunk,
+                xMap, yMap, command, buffers[i] );
+        }
+    }
+    for ( int i = 0; i < futures.size(); i++ )
+        futures[i].waitForFinished();
+
+    const int bandSize = ( numPixels + numThreads - 1 ) / numThreads;
+
+    quint32 maxCount = 0;
+    {
+        QList< QFuture< quint32 > > reduceFutures;
+        for ( uint i = 0; i < numThreads - 1; i++ )
+        {
+            const int j1 = qMin( int( i ) * bandSize, numPixels );
+            const int j2 = qMin( j1 + bandSize, numPixels );
+
+            reduceFutures += QtConcurrent::run( &qwtReduceHits,
+                &buffers, j1, j2 );
+        }
+
+        maxCount = qwtReduceHits( &buffers,
+            qMin( int( numThreads - 1 ) * bandSize, numPixels ), numPixels );
+
+        for ( int i = 0; i < reduceFutures.size(); i++ )
+            maxCount = qMax( maxCount, reduceFutures[i].result() );
+    }
+
+    const QwtDensityColors colors( &colorMap, transform, maxCount );
+
+    futures.clear();
+    for ( uint i = 0; i < numThreads; i++ )
+    {
+        const int j1 = qMin( int( i ) * bandSize, numPixels );
+        const int j2 = qMin( j1 + bandSize, numPixels );
+
+        if ( i == numThreads - 1 )
+        {
+            qwtColorizeHits( buffers[0], j1, j2, &colors, &image );
+        }
+        else
+        {
+            futures += QtConcurrent::run( &qwtColorizeHits,
+                buffers[0], j1, j2, &colors, &image );
+        }
+    }
+    for ( int i = 0; i < futures.size(); i++ )
+        futures[i].waitForFinished();
+#else
+    command.from = from;
+    command.to = to;
+
+    qwtCountHitsChunk( xMap, yMap, command, buffers[0] );
+
+    const quint32 maxCount = qwtReduceHits( &buffers, 0, numPixels );
+    const QwtDensityColors colors( &colorMap, transform, maxCount );
+
+    qwtColorizeHits( buffers[0], 0, numPixels, &colors, &image );
+#endif
+
+    return image;
+}
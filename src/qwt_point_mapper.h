@@ -20,6 +20,9 @@ class QRectF;
 class QPolygon;
 class QPen;
 class QImage;
+class QwtColorMap;
+class QwtTransform;
+class QPoint;
 
 /*!
    \brief A helper class for translating a series of points
@@ -83,10 +86,12 @@ class QWT_EXPORT QwtPointMapper
     QRectF boundingRect() const;
 
     QPolygonF toPolygonF( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-        const QwtSeriesData< QPointF >* series, int from, int to ) const;
+        const QwtSeriesData< QPointF >* series, int from, int to,
+        uint numThreads = 1 ) const;
 
     QPolygon toPolygon( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
-        const QwtSeriesData< QPointF >* series, int from, int to ) const;
+        const QwtSeriesData< QPointF >* series, int from, int to,
+        uint numThreads = 1 ) const;
 
     QPolygon toPoints( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
         const QwtSeriesData< QPointF >* series, int from, int to ) const;
@@ -98,6 +103,14 @@ class QWT_EXPORT QwtPointMapper
         const QwtSeriesData< QPointF >* series, int from, int to,
         const QPen&, bool antialiased, uint numThreads ) const;
 
+    QImage toImage( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+        const QwtSeriesData< QPointF >* series, int from, int to,
+        const QImage& sprite, const QPoint& hotSpot, uint numThreads ) const;
+
+    QImage toDensityImage( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+        const QwtSeriesData< QPointF >* series, int from, int to,
+        const QwtColorMap&, const QwtTransform*, uint numThreads ) const;
+
   private:
     Q_DISABLE_COPY(QwtPointMapper)
 
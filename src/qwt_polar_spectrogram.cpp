@@ -33,6 +33,76 @@ class QwtPolarSpectrogram::TileInfo
     QImage* image;
 };
 
+namespace
+{
+    /*
+       Polar coordinates of the pixels of an image in paint coordinates.
+       They depend on the position of the pole and the image rectangle
+       only and can be reused as long as the plot is not resized or panned.
+     */
+    class PolarGrid
+    {
+      public:
+        PolarGrid()
+            : fastAtan( false )
+            , isValid( false )
+        {
+        }
+
+        bool matches( const QPointF& pole, const QRect& rect, bool fastAtan ) const
+        {
+            return ( this->pole == pole ) && ( this->rect == rect )
+                   && ( this->fastAtan == fastAtan );
+        }
+
+        QPointF pole;
+        QRect rect;
+        bool fastAtan;
+
+        // false, until all rows have been filled by renderTile()
+        bool isValid;
+
+        // floats, as the grid might have millions of pixels
+        QVector< float > angles; // [0.0, 2 * M_PI[
+        QVector< float > radii;
+    };
+}
+
+static void qwtPolarCoordinates( const QPointF& pole, int y,
+    int x1, int numPixels, bool doFastAtan, double* angles, double* radii )
+{
+    const double dy = pole.y() - y;
+    const double dy2 = qwtSqr( dy );
+
+    for ( int i = 0; i < numPixels; i++ )
+    {
+        const double dx = x1 + i - pole.x();
+
+        double a = doFastAtan ? qwtFastAtan2( dy, dx ) : qAtan2( dy, dx );
+        if ( a < 0.0 )
+            a += 2 * M_PI;
+
+        angles[i] = a;
+        radii[i] = qSqrt( qwtSqr( dx ) + dy2 );
+    }
+}
+
+static void qwtStoreGridRow( const double* angles, const double* radii,
+    int numPixels, float* gridAngles, float* gridRadii )
+{
+    for ( int i = 0; i < numPixels; i++ )
+    {
+        float a = static_cast< float >( angles[i] );
+
+        // rounding might end up at 2 * M_PI
+        if ( a >= 2 * M_PI )
+            a = 0.0f;
+
+        gridAngles[i] = a;
+        gridRadii[i] = static_cast< float >( radii[i] );
+    }
+}
+
 class QwtPolarSpectrogram::PrivateData
 {
   public:
@@ -52,6 +122,8 @@ class QwtPolarSpectrogram::PrivateData
     QwtColorMap* colorMap;
 
     QwtPolarSpectrogram::PaintAttributes paintAttributes;
+
+    PolarGrid grid;
 };
 
 //!  Constructor
@@ -229,6 +301,11 @@ void QwtPolarSpectrogram::draw( QPainter* painter,
    \return A QImage::Format_Indexed8 or QImage::Format_ARGB32 depending
            on the color map.
 
+   \note The polar coordinates of the pixels are cached and reused
+         as long as the position of the pole and the rectangle of the
+         image don't change. For an image of w * h pixels the cache
+         needs w * h * 2 floats.
+
    \sa QwtRasterData::intensity(), QwtColorMap::rgb(),
        QwtColorMap::colorIndex()
  */
@@ -257,6 +334,22 @@ QImage QwtPolarSpectrogram::renderImage(
      */
     m_data->data->initRaster( QRectF(), QSize() );
 
+    PolarGrid& grid = m_data->grid;
+
+    const bool doFastAtan = testPaintAttribute( ApproximatedAtan );
+    if ( !grid.matches( pole, rect, doFastAtan ) )
+    {
+        grid.pole = pole;
+        grid.rect = rect;
+        grid.fastAtan = doFastAtan;
+        grid.isValid = false;
+
+        const int numPixels = rect.isEmpty() ? 0 : rect.width() * rect.height();
+
+        // assigning new vectors releases the memory of a larger grid
+        grid.angles = QVector< float >( numPixels );
+        grid.radii = QVector< float >( numPixels );
+    }
 
 #if !defined( QT_NO_QFUTURE )
     uint numThreads = renderThreadCount();
@@ -311,6 +404,9 @@ QImage QwtPolarSpectrogram::renderImage(
     renderTile( azimuthMap, radialMap, pole, rect.topLeft(), rect, &image );
 #endif
 
+    // all rows of the grid have been filled by the tiles
+    grid.isValid = true;
+
     m_data->data->discardRaster();
 
     return image;
@@ -330,6 +426,11 @@ void QwtPolarSpectrogram::renderTileInfo(
    renderTile() is called by renderImage() to render different parts
    of the image by concurrent threads.
 
+   The polar coordinates of the pixels are taken from the cache
+   of renderImage(). The values of a row of pixels are fetched
+   by one call of QwtRasterData::pointValues() and mapped into colors by
+   QwtColorMap::rgbValues() or QwtColorMap::colorIndex().
+
    \param azimuthMap Maps azimuth values to values related to 0.0, M_2PI
    \param radialMap Maps radius values into painter coordinates.
    \param pole Position of the pole in painter coordinates
@@ -357,75 +458,103 @@ void QwtPolarSpectrogram::renderTile(
 
     const int x0 = imagePos.x();
     const int x1 = tile.left();
-    const int x2 = tile.right();
 
-    if ( m_data->colorMap->format() == QwtColorMap::RGB )
+    const int numPixels = tile.width();
+    if ( numPixels <= 0 )
+        return;
+
+    /*
+        The grid is prepared by renderImage() and covers the tiles
+        of the image. When being called from somewhere else we
+        calculate the polar coordinates for each row.
+     */
+    PolarGrid& grid = m_data->grid;
+
+    const bool useGrid = grid.pole == pole && grid.fastAtan == doFastAtan
+        && grid.rect.topLeft() == imagePos && grid.rect.contains( tile );
+
+    QVector< double > buffer( 5 * numPixels );
+
+    double* azimuths = buffer.data();
+    double* radii = azimuths + numPixels;
+    double* values = radii + numPixels;
+
+    // polar coordinates of a row
+    double* rowAngles = values + numPixels;
+    double* rowRadii = rowAngles + numPixels;
+
+    const double p1 = azimuthMap.p1();
+
+    for ( int y = y1; y <= y2; y++ )
     {
-        for ( int y = y1; y <= y2; y++ )
+        if ( useGrid )
         {
-            const double dy = pole.y() - y;
-            const double dy2 = qwtSqr( dy );
+            const int offset = ( y - y0 ) * grid.rect.width() + ( x1 - x0 );
 
-            QRgb* line = reinterpret_cast< QRgb* >( image->scanLine( y - y0 ) );
-            line += x1 - x0;
+            float* gridAngles = grid.angles.data() + offset;
+            float* gridRadii = grid.radii.data() + offset;
 
-            for ( int x = x1; x <= x2; x++ )
+            // the tiles are filling disjoint rows of the grid
+            if ( !grid.isValid )
             {
-                const double dx = x - pole.x();
+                qwtPolarCoordinates( pole, y, x1, numPixels,
+                    doFastAtan, rowAngles, rowRadii );
 
-                double a = doFastAtan ? qwtFastAtan2( dy, dx ) : qAtan2( dy, dx );
+                qwtStoreGridRow( rowAngles, rowRadii,
+                    numPixels, gridAngles, gridRadii );
+            }
 
-                if ( a < 0.0 )
-                    a += 2 * M_PI;
+            // always using the stored values, so that all images are identical
+            for ( int i = 0; i < numPixels; i++ )
+            {
+                rowAngles[i] = gridAngles[i];
+                rowRadii[i] = gridRadii[i];
+            }
+        }
+        else
+        {
+            qwtPolarCoordinates( pole, y, x1, numPixels,
+                doFastAtan, rowAngles, rowRadii );
+        }
+
+        for ( int i = 0; i < numPixels; i++ )
+        {
+            double a = rowAngles[i];
+            if ( a < p1 )
+                a += 2 * M_PI;
+
+            azimuths[i] = azimuthMap.invTransform( a );
+        }
 
-                if ( a < azimuthMap.p1() )
-                    a += 2 * M_PI;
+        for ( int i = 0; i < numPixels; i++ )
+            radii[i] = radialMap.invTransform( rowRadii[i] );
 
-                const double r = qSqrt( qwtSqr( dx ) + dy2 );
+        m_data->data->pointValues( azimuths, radii, numPixels, values );
+
+        if ( m_data->colorMap->format() == QwtColorMap::RGB )
+        {
+            QRgb* line = reinterpret_cast< QRgb* >( image->scanLine( y - y0 ) );
+            line += x1 - x0;
 
-                const double azimuth = azimuthMap.invTransform( a );
-                const double radius = radialMap.invTransform( r );
+            m_data->colorMap->rgbValues( intensityRange, values, numPixels, line );
 
-                const double value = m_data->data->value( azimuth, radius );
-                if ( qIsNaN( value ) )
-                {
-                    *line++ = 0u;
-                }
-                else
-                {
-                    *line++ = m_data->colorMap->rgb( intensityRange, value );
-                }
+            for ( int i = 0; i < numPixels; i++ )
+            {
+                if ( qIsNaN( values[i] ) )
+                    line[i] = 0u;
             }
         }
-    }
-    else if ( m_data->colorMap->format() == QwtColorMap::Indexed )
-    {
-        for ( int y = y1; y <= y2; y++ )
+        else if ( m_data->colorMap->format() == QwtColorMap::Indexed )
         {
-            const double dy = pole.y() - y;
-            const double dy2 = qwtSqr( dy );
-
             unsigned char* line = image->scanLine( y - y0 );
             line += x1 - x0;
-            for ( int x = x1; x <= x2; x++ )
-            {
-                const double dx = x - pole.x();
 
-                double a = doFastAtan ? qwtFastAtan2( dy, dx ) : qAtan2( dy, dx );
-                if ( a < 0.0 )
-                    a += 2 * M_PI;
-                if ( a < azimuthMap.p1() )
-                    a += 2 * M_PI;
-
-                const double r = qSqrt( qwtSqr( dx ) + dy2 );
-
-                const double azimuth = azimuthMap.invTransform( a );
-                const double radius = radialMap.invTransform( r );
-
-                const double value = m_data->data->value( azimuth, radius );
+            for ( int i = 0; i < numPixels; i++ )
+            {
+                const uint index = m_data->colorMap->colorIndex(
+                    256, intensityRange, values[i] );
 
-                const uint index = m_data->colorMap->colorIndex( 256, intensityRange, value );
-                *line++ = static_cast< unsigned char >( index );
+                line[i] = static_cast< unsigned char >( index );
             }
         }
     }
@@ -0,0 +1,478 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_pyramid_point_data.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // number of samples summarized by a bucket of the first level
+    const size_t qwtBaseBucketSize = 8;
+
+    // number of buckets summarized by a bucket of the next level
+    const int qwtBucketFactor = 4;
+
+    class Bucket
+    {
+      public:
+        size_t minIndex;
+        size_t maxIndex;
+    };
+}
+
+static inline size_t qwtBucketSize( int level )
+{
+    return qwtBaseBucketSize << ( 2 * level );
+}
+
+static inline void qwtAppendIndex( QVector< size_t >& indices, size_t index )
+{
+    // indices are appended in increasing order, so checking
+    // the last one is enough to avoid duplicates
+
+    if ( indices.isEmpty() || indices.last() != index )
+        indices += index;
+}
+
+class QwtPyramidPointData::PrivateData
+{
+  public:
+    PrivateData()
+        : resolution( 1024 )
+        , rectOfInterest( 0.0, 0.0, -1.0, -1.0 )
+        , level( -1 )
+        , from( 0 )
+        , to( -1 )
+        , revision( 0 )
+    {
+    }
+
+    QVector< double > x;
+    QVector< double > y;
+
+    QVector< QVector< Bucket > > levels;
+
+    int resolution;
+    QRectF rectOfInterest;
+
+    // the current selection
+    int level;
+    int from;
+    int to;
+    QVector< size_t > indices;
+
+    quint64 revision;
+};
+
+/*!
+   Constructor
+
+   Creates an empty series
+ */
+QwtPyramidPointData::QwtPyramidPointData()
+{
+    m_data = new PrivateData();
+}
+
+/*!
+   Constructor
+
+   \param x Array of x values, that need to be monotonically increasing
+   \param y Array of y values
+
+   \sa setSamples()
+ */
+QwtPyramidPointData::QwtPyramidPointData(
+    const QVector< double >& x, const QVector< double >& y )
+{
+    m_data = new PrivateData();
+    setSamples( x, y );
+}
+
+/*!
+   Constructor
+
+   \param x Array of x values, that need to be monotonically increasing
+   \param y Array of y values
+   \param size Size of the x and y arrays
+
+   \sa setSamples()
+ */
+QwtPyramidPointData::QwtPyramidPointData(
+    const double* x, const double* y, size_t size )
+{
+    m_data = new PrivateData();
+    setSamples( x, y, size );
+}
+
+//! Destructor
+QwtPyramidPointData::~QwtPyramidPointData()
+{
+    delete m_data;
+}
+
+/*!
+   Assign the samples and rebuild the pyramid
+
+   \param x Array of x values, that need to be monotonically increasing
+   \param y Array of y values
+ */
+void QwtPyramidPointData::setSamples(
+    const QVector< double >& x, const QVector< double >& y )
+{
+    m_data->x = x;
+    m_data->y = y;
+
+    buildPyramid();
+    updateSelection();
+}
+
+/*!
+   Copy the samples and rebuild the pyramid
+
+   \param x Array of x values, that need to be monotonically increasing
+   \param y Array of y values
+   \param size Size of the x and y arrays
+ */
+void QwtPyramidPointData::setSamples(
+    const double* x, const double* y, size_t size )
+{
+    m_data->x.resize( size );
+    std::memcpy( m_data->x.data(), x, size * sizeof( double ) );
+
+    m_data->y.resize( size );
+    std::memcpy( m_data->y.data(), y, size * sizeof( double ) );
+
+    buildPyramid();
+    updateSelection();
+}
+
+/*!
+   \brief Set the resolution
+
+   The resolution is the number of pixels, that are available for
+   displaying the rectangle of interest - usually the width of the canvas.
+   As the canvas geometry is not known to the series it has to
+   be updated by the application, when the canvas gets resized.
+
+   A resolution <= 0 disables the level of details and the original
+   samples of the rectangle of interest are served.
+
+   The default setting is 1024.
+
+   \param pixels Number of pixels
+   \sa resolution(), setRectOfInterest()
+ */
+void QwtPyramidPointData::setResolution( int pixels )
+{
+    if ( pixels != m_data->resolution )
+    {
+        m_data->resolution = pixels;
+        updateSelection();
+    }
+}
+
+/*!
+   \return Number of pixels available for the rectangle of interest
+   \sa setResolution()
+ */
+int QwtPyramidPointData::resolution() const
+{
+    return m_data->resolution;
+}
+
+/*!
+   \return Number of samples of the current selection
+   \sa dataSize(), setRectOfInterest()
+ */
+size_t QwtPyramidPointData::size() const
+{
+    if ( m_data->level >= 0 )
+        return m_data->indices.size();
+
+    return m_data->to - m_data->from + 1;
+}
+
+/*!
+   \return Sample of the current selection
+   \param index Index
+   \sa dataSample(), setRectOfInterest()
+ */
+QPointF QwtPyramidPointData::sample( size_t index ) const
+{
+    if ( m_data->level >= 0 )
+        index = m_data->indices[ int( index ) ];
+    else
+        index += m_data->from;
+
+    return QPointF( m_data->x[ int( index ) ], m_data->y[ int( index ) ] );
+}
+
+/*!
+   \return Bounding rectangle of all samples
+
+   The rectangle is calculated from the top level of the pyramid
+   and does not depend on the rectangle of interest.
+ */
+QRectF QwtPyramidPointData::boundingRect() const
+{
+    return cachedBoundingRect;
+}
+
+/*!
+   \brief Direct access to the x and y coordinates
+
+   As long as the original samples are served the coordinates
+   of the current selection are available in contiguous memory.
+
+   \param xValues Return parameter for the x coordinates
+   \param yValues Return parameter for the y coordinates
+
+   \return true, when currentLevel() is -1
+ */
+bool QwtPyramidPointData::contiguousValues(
+    const double** xValues, const double** yValues ) const
+{
+    if ( m_data->level >= 0 )
+        return false;
+
+    *xValues = m_data->x.constData() + m_data->from;
+    *yValues = m_data->y.constData() + m_data->from;
+
+    return true;
+}
+
+/*!
+   Set the "rectangle of interest" and select the samples
+   to be served by size() and sample()
+
+   \param rect Rectangle of interest
+   \sa rectOfInterest(), setResolution()
+ */
+void QwtPyramidPointData::setRectOfInterest( const QRectF& rect )
+{
+    const QRectF r = rect.normalized();
+    if ( r != m_data->rectOfInterest )
+    {
+        m_data->rectOfInterest = r;
+        updateSelection();
+    }
+}
+
+/*!
+   \return "rectangle of interest"
+   \sa setRectOfInterest()
+ */
+QRectF QwtPyramidPointData::rectOfInterest() const
+{
+    return m_data->rectOfInterest;
+}
+
+/*!
+   \return Revision of the current selection, that changes with
+           the samples and the rectangle of interest
+   \sa QwtSeriesData::revision()
+ */
+quint64 QwtPyramidPointData::revision() const
+{
+    return m_data->revision;
+}
+
+/*!
+   \return Number of original samples
+   \sa size()
+ */
+size_t QwtPyramidPointData::dataSize() const
+{
+    return qMin( m_data->x.size(), m_data->y.size() );
+}
+
+/*!
+   \return Original sample
+   \param index Index
+   \sa sample()
+ */
+QPointF QwtPyramidPointData::dataSample( size_t index ) const
+{
+    return QPointF( m_data->x[ int( index ) ], m_data->y[ int( index ) ] );
+}
+
+//! \return Array of the x-values
+const QVector< double >& QwtPyramidPointData::xData() const
+{
+    return m_data->x;
+}
+
+//! \return Array of the y-values
+const QVector< double >& QwtPyramidPointData::yData() const
+{
+    return m_data->y;
+}
+
+//! \return Number of levels of the pyramid
+int QwtPyramidPointData::levelCount() const
+{
+    return m_data->levels.size();
+}
+
+/*!
+   \return Level of the pyramid, that is used for the current selection.
+           -1 means, that the original samples are served.
+ */
+int QwtPyramidPointData::currentLevel() const
+{
+    return m_data->level;
+}
+
+void QwtPyramidPointData::buildPyramid()
+{
+    m_data->levels.clear();
+    cachedBoundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+
+    const size_t numSamples = dataSize();
+    if ( numSamples == 0 )
+        return;
+
+    const double* y = m_data->y.constData();
+
+    QVector< Bucket > buckets( int( ( numSamples + qwtBaseBucketSize - 1 ) / qwtBaseBucketSize ) );
+    for ( int i = 0; i < buckets.size(); i++ )
+    {
+        const size_t from = i * qwtBaseBucketSize;
+        const size_t to = qMin( from + qwtBaseBucketSize, numSamples );
+
+        Bucket& bucket = buckets[i];
+        bucket.minIndex = bucket.maxIndex = from;
+
+        for ( size_t j = from + 1; j < to; j++ )
+        {
+            if ( y[j] < y[bucket.minIndex] )
+                bucket.minIndex = j;
+            else if ( y[j] > y[bucket.maxIndex] )
+                bucket.maxIndex = j;
+        }
+    }
+
+    m_data->levels += buckets;
+
+    while ( buckets.size() > 1 )
+    {
+        const QVector< Bucket > children = buckets;
+
+        buckets.resize( ( children.size() + qwtBucketFactor - 1 ) / qwtBucketFactor );
+        for ( int i = 0; i < buckets.size(); i++ )
+        {
+            const int from = i * qwtBucketFactor;
+            const int to = qMin( from + qwtBucketFactor, children.size() );
+
+            Bucket& bucket = buckets[i];
+            bucket = children[from];
+
+            for ( int j = from + 1; j < to; j++ )
+            {
+                if ( y[ children[j].minIndex ] < y[ bucket.minIndex ] )
+                    bucket.minIndex = children[j].minIndex;
+
+                if ( y[ children[j].maxIndex ] > y[ bucket.maxIndex ] )
+                    bucket.maxIndex = children[j].maxIndex;
+            }
+        }
+
+        m_data->levels += buckets;
+    }
+
+    const Bucket& top = m_data->levels.last().first();
+
+    const double x1 = m_data->x.first();
+    const double x2 = m_data->x[ int( numSamples - 1 ) ];
+
+    cachedBoundingRect = QRectF( x1, y[top.minIndex],
+        x2 - x1, y[top.maxIndex] - y[top.minIndex] );
+}
+
+void QwtPyramidPointData::updateSelection()
+{
+    /*
+        The selection never has more samples than the original
+        samples, so the new revision can't be taken for an append.
+     */
+    m_data->revision += dataSize() + 1;
+
+    m_data->indices.clear();
+    m_data->level = -1;
+
+    const int numSamples = int( dataSize() );
+
+    m_data->from = 0;
+    m_data->to = numSamples - 1;
+
+    if ( numSamples == 0 )
+        return;
+
+    const QRectF& rect = m_data->rectOfInterest;
+    if ( rect.width() > 0.0 )
+    {
+        // including the neighbours outside of the interval, so
+        // that the lines to the borders of the canvas are not lost
+
+        const double* x = m_data->x.constData();
+
+        const int from = int( std::lower_bound( x, x + numSamples, rect.left() ) - x ) - 1;
+        const int to = int( std::upper_bound( x, x + numSamples, rect.right() ) - x );
+
+        m_data->from = qMax( from, 0 );
+        m_data->to = qMin( to, numSamples - 1 );
+    }
+
+    const int resolution = m_data->resolution;
+    const int count = m_data->to - m_data->from + 1;
+
+    if ( resolution <= 0 || count <= 4 * resolution )
+        return;
+
+    const double samplesPerPixel = double( count ) / resolution;
+
+    int level = -1;
+    for ( int i = 0; i < m_data->levels.size(); i++ )
+    {
+        if ( qwtBucketSize( i ) > samplesPerPixel )
+            break;
+
+        level = i;
+    }
+
+    if ( level < 0 )
+        return;
+
+    const QVector< Bucket >& buckets = m_data->levels[level];
+    const size_t bucketSize = qwtBucketSize( level );
+
+    const int bucket1 = int( m_data->from / bucketSize );
+    const int bucket2 = int( m_data->to / bucketSize );
+
+    QVector< size_t >& indices = m_data->indices;
+    indices.reserve( 4 * ( bucket2 - bucket1 + 1 ) );
+
+    for ( int i = bucket1; i <= bucket2; i++ )
+    {
+        const Bucket& bucket = buckets[i];
+
+        const size_t first = i * bucketSize;
+        const size_t last = qMin( first + bucketSize, size_t( numSamples ) ) - 1;
+
+        qwtAppendIndex( indices, first );
+        qwtAppendIndex( indices, qMin( bucket.minIndex, bucket.maxIndex ) );
+        qwtAppendIndex( indices, qMax( bucket.minIndex, bucket.maxIndex ) );
+        qwtAppendIndex( indices, last );
+    }
+
+    m_data->level = level;
+}
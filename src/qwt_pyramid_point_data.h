@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PYRAMID_POINT_DATA_H
+#define QWT_PYRAMID_POINT_DATA_H
+
+#include "qwt_global.h"
+#include "qwt_series_data.h"
+
+/*!
+   \brief Series data with levels of detail for huge curves
+
+   QwtPyramidPointData is intended for curves with millions of points
+   having monotonically increasing x coordinates - like the traces
+   of a data acquisition system.
+
+   When assigning the samples a pyramid of min/max buckets is built:
+   on the first level each bucket summarizes 8 samples, on each
+   following level a bucket summarizes 4 buckets of the level below.
+   A bucket is represented by up to 4 samples: the first sample,
+   the samples with the minimum and maximum y coordinates and the
+   last sample. This is the same reduction that is done by
+   QwtPointMapper::WeedOutIntermediatePoints for a column of pixels,
+   but precalculated.
+
+   The "rectangle of interest", that is set by the plot item, and
+   the resolution() are used to select the level, where approximately
+   one bucket is mapped to one pixel. Then size() and sample() only
+   iterate over the samples of the buckets overlapping the visible
+   x interval. So the costs of a replot depend on the width of the
+   canvas and no longer on the total number of samples.
+
+   When the number of visible samples is not significantly larger
+   than the resolution, the original samples of the visible interval
+   are served.
+
+   \note The indices of size() and sample() are related to the
+         current selection of samples and change with the
+         rectangle of interest. Use dataSize() and dataSample()
+         to access the original samples.
+
+   \sa QwtPointMapper::WeedOutIntermediatePoints,
+       QwtPlotCurve::setPaintAttribute()
+ */
+class QWT_EXPORT QwtPyramidPointData : public QwtSeriesData< QPointF >
+{
+  public:
+    QwtPyramidPointData();
+    QwtPyramidPointData( const QVector< double >& x, const QVector< double >& y );
+    QwtPyramidPointData( const double* x, const double* y, size_t size );
+
+    virtual ~QwtPyramidPointData();
+
+    void setSamples( const QVector< double >& x, const QVector< double >& y );
+    void setSamples( const double* x, const double* y, size_t size );
+
+    void setResolution( int pixels );
+    int resolution() const;
+
+    virtual size_t size() const QWT_OVERRIDE;
+    virtual QPointF sample( size_t index ) const QWT_OVERRIDE;
+
+    virtual QRectF boundingRect() const QWT_OVERRIDE;
+
+    virtual bool contiguousValues(
+        const double** xValues, const double** yValues ) const QWT_OVERRIDE;
+
+    virtual void setRectOfInterest( const QRectF& ) QWT_OVERRIDE;
+    QRectF rectOfInterest() const;
+
+    virtual quint64 revision() const QWT_OVERRIDE;
+
+    size_t dataSize() const;
+    QPointF dataSample( size_t index ) const;
+
+    const QVector< double >& xData() const;
+    const QVector< double >& yData() const;
+
+    int levelCount() const;
+    int currentLevel() const;
+
+  private:
+    Q_DISABLE_COPY( QwtPyramidPointData )
+
+    void buildPyramid();
+    void updateSelection();
+
+    class PrivateData;
+    PrivateData* m_data;
+};
+
+#endif
@@ -16,6 +16,19 @@
 #include <qnumeric.h>
 #include <qlist.h>
 #include <qmap.h>
+#include <qvector.h>
+#include <qhash.h>
+#include <qbitarray.h>
+
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+#include <cstring>
+
+#if !defined( QT_NO_QFUTURE )
+#define QWT_USE_THREADS 1
+#endif
 
 class QwtRasterData::ContourPlane
 {
@@ -164,7 +177,13 @@ inline QPointF QwtRasterData::ContourPlane::intersection(
 class QwtRasterData::PrivateData
 {
   public:
+    PrivateData()
+        : contourThreadCount( 1 )
+    {
+    }
+
     QwtRasterData::Attributes attributes;
+    uint contourThreadCount;
 };
 
 //! Constructor
@@ -203,6 +222,17 @@ bool QwtRasterData::testAttribute( Attribute attribute ) const
     return m_data->attributes & attribute;
 }
 
+/*
+   The number of threads for calculating contour lines is an internal
+   parameter, that is set by QwtPlotSpectrogram::renderContourLines()
+   from QwtPlotItem::renderThreadCount() for the duration of a
+   contourLines() call.
+ */
+void QwtRasterData::setContourThreadCount( uint numThreads )
+{
+    m_data->contourThreadCount = numThreads;
+}
+
 /*!
    \brief Initialize a raster
 
@@ -238,6 +268,69 @@ void QwtRasterData::discardRaster()
 {
 }
 
+/*!
+   \brief Values for a grid of positions
+
+   values() returns the values for all combinations of the x and y
+   positions, what usually corresponds to the centers of the pixels of
+   a tile of an image. Implementations can precalculate everything,
+   that depends on x or y only, once for all rows and columns
+   instead of doing it for each value.
+
+   The default implementation calls value() for each position.
+
+   \param xValues X values in plot coordinates
+   \param numColumns Number of x values
+   \param yValues Y values in plot coordinates
+   \param numRows Number of y values
+   \param values Array for numRows * numColumns values, where the value
+                 for ( xValues[col], yValues[row] ) is stored
+                 at values[ row * numColumns + col ]
+
+   \note values() has to return the same results as value() and is
+         called from the render threads of QwtPlotSpectrogram like value().
+
+   \sa value(), QwtPlotSpectrogram::renderTile()
+ */
+void QwtRasterData::values( const double* xValues, int numColumns,
+    const double* yValues, int numRows, double* values ) const
+{
+    for ( int row = 0; row < numRows; row++ )
+    {
+        const double y = yValues[row];
+
+        for ( int col = 0; col < numColumns; col++ )
+            *values++ = value( xValues[col], y );
+    }
+}
+
+/*!
+   \brief Values for a list of positions
+
+   pointValues() returns the values for positions, that are not
+   on a grid - f.e. the pixels of an image in polar coordinates.
+   Implementations can avoid doing everything, that is independent
+   of the position, for each value.
+
+   The default implementation calls value() for each position.
+
+   \param xValues X values in plot coordinates
+   \param yValues Y values in plot coordinates
+   \param numPoints Number of positions
+   \param values Array for numPoints values
+
+   \note pointValues() has to return the same results as value()
+         and is called from render threads like value().
+
+   \sa value(), values(), QwtPolarSpectrogram::renderTile()
+ */
+void QwtRasterData::pointValues( const double* xValues,
+    const double* yValues, int numPoints, double* values ) const
+{
+    for ( int i = 0; i < numPoints; i++ )
+        values[i] = value( xValues[i], yValues[i] );
+}
+
 /*!
    \brief Pixel hint
 
@@ -270,91 +363,127 @@ QRectF QwtRasterData::pixelHint( const QRectF& area ) const
     return QRectF();
 }
 
-/*!
-   Calculate contour lines
+namespace
+{
+    class PointKey
+    {
+      public:
+        inline PointKey( const QPointF& pos )
+            // + 0.0 normalizes -0.0, so that equal points have the same bits
+            : x( pos.x() + 0.0 )
+            , y( pos.y() + 0.0 )
+        {
+        }
 
-   \param rect Bounding rectangle for the contour lines
-   \param raster Number of data pixels of the raster data
-   \param levels List of limits, where to insert contour lines
-   \param flags Flags to customize the contouring algorithm
+        inline bool operator==( const PointKey& other ) const
+        {
+            return ( x == other.x ) && ( y == other.y );
+        }
 
-   \return Calculated contour lines
+        double x;
+        double y;
+    };
 
-   An adaption of CONREC, a simple contouring algorithm.
-   http://local.wasp.uwa.edu.au/~pbourke/papers/conrec/
- */
-QwtRasterData::ContourLines QwtRasterData::contourLines(
-    const QRectF& rect, const QSize& raster,
-    const QList< double >& levels, ConrecFlags flags ) const
-{
-    ContourLines contourLines;
+    inline uint qHash( const PointKey& key )
+    {
+        quint64 x, y;
+        std::memcpy( &x, &key.x, sizeof( x ) );
+        std::memcpy( &y, &key.y, sizeof( y ) );
 
-    if ( levels.size() == 0 || !rect.isValid() || !raster.isValid() )
-        return contourLines;
+        const quint64 h = x ^ ( y + Q_UINT64_C( 0x9e3779b97f4a7c15 ) + ( x << 6 ) + ( x >> 2 ) );
+        return uint( h ^ ( h >> 32 ) );
+    }
 
-    const double dx = rect.width() / raster.width();
-    const double dy = rect.height() / raster.height();
+    class ContourGrid
+    {
+      public:
+        const QwtRasterData* data;
 
-    const bool ignoreOnPlane =
-        flags & QwtRasterData::IgnoreAllVerticesOnLevel;
+        double x0;
+        double y0;
+        double dx;
+        double dy;
 
-    const QwtInterval range = interval( Qt::ZAxis );
-    bool ignoreOutOfRange = false;
-    if ( range.isValid() )
-        ignoreOutOfRange = flags & IgnoreOutOfRange;
+        int width;
+        QVector< double > values;
+    };
 
-    QwtRasterData* that = const_cast< QwtRasterData* >( this );
-    that->initRaster( rect, raster );
+    class ContourCommand
+    {
+      public:
+        const ContourGrid* grid;
+
+        QVector< double > levels;
+        bool ignoreOnPlane;
 
-    for ( int y = 0; y < raster.height() - 1; y++ )
+        bool ignoreOutOfRange;
+        QwtInterval range;
+    };
+}
+
+static void qwtSampleContourGrid( ContourGrid* grid, int row0, int row1 )
+{
+    const QwtRasterData* data = grid->data;
+
+    for ( int y = row0; y < row1; y++ )
     {
-        enum Position
-        {
-            Center,
+        const double ty = grid->y0 + y * grid->dy;
 
-            TopLeft,
-            TopRight,
-            BottomRight,
-            BottomLeft,
+        double* values = grid->values.data() + y * grid->width;
+        for ( int x = 0; x < grid->width; x++ )
+            values[x] = data->value( grid->x0 + x * grid->dx, ty );
+    }
+}
 
-            NumPositions
-        };
+/*
+    CONREC for the cells of the rows [row0, row1[,
+    returning one polygon of line segments for each level
+ */
+static QVector< QPolygonF > qwtContourBand(
+    const ContourCommand* command, int row0, int row1 )
+{
+    enum Position
+    {
+        Center,
 
-        QwtPoint3D xy[NumPositions];
+        TopLeft,
+        TopRight,
+        BottomRight,
+        BottomLeft,
 
-        for ( int x = 0; x < raster.width() - 1; x++ )
-        {
-            const QPointF pos( rect.x() + x * dx, rect.y() + y * dy );
+        NumPositions
+    };
 
-            if ( x == 0 )
-            {
-                xy[TopRight].setX( pos.x() );
-                xy[TopRight].setY( pos.y() );
-                xy[TopRight].setZ(
-                    value( xy[TopRight].x(), xy[TopRight].y() )
-                    );
-
-                xy[BottomRight].setX( pos.x() );
-                xy[BottomRight].setY( pos.y() + dy );
-                xy[BottomRight].setZ(
-                    value( xy[BottomRight].x(), xy[BottomRight].y() )
-                    );
-            }
+    const ContourGrid* grid = command->grid;
 
-            xy[TopLeft] = xy[TopRight];
-            xy[BottomLeft] = xy[BottomRight];
+    const double dx = grid->dx;
+    const double dy = grid->dy;
+    const int width = grid->width;
 
-            xy[TopRight].setX( pos.x() + dx );
-            xy[TopRight].setY( pos.y() );
-            xy[BottomRight].setX( pos.x() + dx );
-            xy[BottomRight].setY( pos.y() + dy );
+    const double* levels = command->levels.constData();
+    const int numLevels = command->levels.size();
 
-            xy[TopRight].setZ(
-                value( xy[TopRight].x(), xy[TopRight].y() )
-                );
-            xy[BottomRight].setZ(
-                value( xy[BottomRight].x(), xy[BottomRight].y() )
-                );
+    QVector< QPolygonF > lines( numLevels );
+
+    QwtPoint3D xy[NumPositions];
+
+    for ( int y = row0; y < row1; y++ )
+    {
+        const double* row = grid->values.constData() + y * width;
+        const double* nextRow = row + width;
+
+        const double y1 = grid->y0 + y * dy;
+        const double y2 = grid->y0 + ( y + 1 ) * dy;
+
+        for ( int x = 0; x < width - 1; x++ )
+        {
+            const double x1 = grid->x0 + x * dx;
+            const double x2 = grid->x0 + ( x + 1 ) * dx;
+
+            xy[TopLeft] = QwtPoint3D( x1, y1, row[x] );
+            xy[TopRight] = QwtPoint3D( x2, y1, row[x + 1] );
+            xy[BottomRight] = QwtPoint3D( x2, y2, nextRow[x + 1] );
+            xy[BottomLeft] = QwtPoint3D( x1, y2, nextRow[x] );
 
             double zMin = xy[TopLeft].z();
             double zMax = zMin;
@@ -377,30 +506,28 @@ QwtRasterData::ContourLines QwtRasterData::contourLines(
                 continue;
             }
 
-            if ( ignoreOutOfRange )
+            if ( command->ignoreOutOfRange )
             {
-                if ( !range.contains( zMin ) || !range.contains( zMax ) )
+                if ( !command->range.contains( zMin ) ||
+                    !command->range.contains( zMax ) )
+                {
                     continue;
+                }
             }
 
-            if ( zMax < levels[0] ||
-                zMin > levels[levels.size() - 1] )
-            {
+            if ( zMax < levels[0] || zMin > levels[numLevels - 1] )
                 continue;
-            }
 
-            xy[Center].setX( pos.x() + 0.5 * dx );
-            xy[Center].setY( pos.y() + 0.5 * dy );
-            xy[Center].setZ( 0.25 * zSum );
+            xy[Center] = QwtPoint3D( x1 + 0.5 * dx, y1 + 0.5 * dy, 0.25 * zSum );
 
-            const int numLevels = levels.size();
             for ( int l = 0; l < numLevels; l++ )
             {
                 const double level = levels[l];
                 if ( level < zMin || level > zMax )
                     continue;
-                QPolygonF& lines = contourLines[level];
-                const ContourPlane plane( level );
+
+                QPolygonF& polygon = lines[l];
+                const QwtRasterData::ContourPlane plane( level );
 
                 QPointF line[2];
                 QwtPoint3D vertex[3];
@@ -412,18 +539,262 @@ QwtRasterData::ContourLines QwtRasterData::contourLines(
                     vertex[2] = xy[m != BottomLeft ? m + 1 : TopLeft];
 
                     const bool intersects =
-                        plane.intersect( vertex, line, ignoreOnPlane );
+                        plane.intersect( vertex, line, command->ignoreOnPlane );
                     if ( intersects )
                     {
-                        lines += line[0];
-                        lines += line[1];
+                        polygon += line[0];
+                        polygon += line[1];
                     }
                 }
             }
         }
     }
 
+    return lines;
+}
+
+static int qwtNumBands( uint numThreads, int numRows )
+{
+#if QWT_USE_THREADS
+    // not worth the overhead of a thread for less rows
+    const int minBandSize = 16;
+
+    int numBands = numThreads;
+    if ( numBands == 0 )
+        numBands = QThread::idealThreadCount();
+
+    return qBound( 1, numBands, numRows / minBandSize );
+#else
+    Q_UNUSED( numThreads );
+    Q_UNUSED( numRows );
+
+    return 1;
+#endif
+}
+
+/*!
+   Calculate contour lines
+
+   \param rect Bounding rectangle for the contour lines
+   \param raster Number of data pixels of the raster data
+   \param levels List of limits, where to insert contour lines
+   \param flags Flags to customize the contouring algorithm
+
+   \return Calculated contour lines
+
+   An adaption of CONREC, a simple contouring algorithm.
+   http://local.wasp.uwa.edu.au/~pbourke/papers/conrec/
+
+   The raster is sampled once into a grid of values, so that value() is
+   called only once for each raster point. Then the cells are processed in
+   bands of rows, that can be calculated in parallel. The segments of the
+   bands are joined in order, so that the result does not depend
+   on the number of threads.
+
+   \note When called from QwtPlotSpectrogram::renderContourLines() the
+         number of threads is QwtPlotItem::renderThreadCount() and
+         value() needs to be thread safe, when it is != 1.
+ */
+QwtRasterData::ContourLines QwtRasterData::contourLines(
+    const QRectF& rect, const QSize& raster,
+    const QList< double >& levels, ConrecFlags flags ) const
+{
+    ContourLines contourLines;
+
+    if ( levels.size() == 0 || !rect.isValid() || !raster.isValid() )
+        return contourLines;
+
+    ContourGrid grid;
+    grid.data = this;
+    grid.x0 = rect.x();
+    grid.y0 = rect.y();
+    grid.dx = rect.width() / raster.width();
+    grid.dy = rect.height() / raster.height();
+    grid.width = raster.width();
+    grid.values.resize( raster.width() * raster.height() );
+
+    ContourCommand command;
+    command.grid = &grid;
+
+    command.levels.reserve( levels.size() );
+    for ( int i = 0; i < levels.size(); i++ )
+        command.levels += levels[i];
+
+    command.ignoreOnPlane = flags & QwtRasterData::IgnoreAllVerticesOnLevel;
+
+    command.range = interval( Qt::ZAxis );
+    command.ignoreOutOfRange = false;
+    if ( command.range.isValid() )
+        command.ignoreOutOfRange = flags & IgnoreOutOfRange;
+
+    QwtRasterData* that = const_cast< QwtRasterData* >( this );
+    that->initRaster( rect, raster );
+
+    const int numRows = raster.height() - 1;
+    const int numBands = qwtNumBands( m_data->contourThreadCount, numRows );
+
+    QVector< QVector< QPolygonF > > bands;
+
+#if QWT_USE_THREADS
+    if ( numBands > 1 )
+    {
+        {
+            const int numSamplingRows = raster.height() / numBands;
+
+            QList< QFuture< void > > futures;
+            for ( int i = 0; i < numBands - 1; i++ )
+            {
+                futures += QtConcurrent::run( &qwtSampleContourGrid, &grid,
+                    i * numSamplingRows, ( i + 1 ) * numSamplingRows );
+            }
+
+            qwtSampleContourGrid( &grid,
+                ( numBands - 1 ) * numSamplingRows, raster.height() );
+
+            for ( int i = 0; i < futures.size(); i++ )
+                futures[i].waitForFinished();
+        }
+
+        const int numBandRows = numRows / numBands;
+
+        QList< QFuture< QVector< QPolygonF > > > futures;
+        for ( int i = 0; i < numBands - 1; i++ )
+        {
+            futures += QtConcurrent::run( &qwtContourBand, &command,
+                i * numBandRows, ( i + 1 ) * numBandRows );
+        }
+
+        const QVector< QPolygonF > lastBand =
+            qwtContourBand( &command, ( numBands - 1 ) * numBandRows, numRows );
+
+        for ( int i = 0; i < futures.size(); i++ )
+            bands.append( futures[i].result() );
+
+        bands.append( lastBand );
+    }
+    else
+#endif
+    {
+        qwtSampleContourGrid( &grid, 0, raster.height() );
+        bands.append( qwtContourBand( &command, 0, numRows ) );
+    }
+
     that->discardRaster();
 
+    for ( int l = 0; l < command.levels.size(); l++ )
+    {
+        int numPoints = 0;
+        for ( int i = 0; i < bands.size(); i++ )
+            numPoints += bands[i][l].size();
+
+        if ( numPoints == 0 )
+            continue;
+
+        QPolygonF& lines = contourLines[ command.levels[l] ];
+        lines.reserve( numPoints );
+
+        for ( int i = 0; i < bands.size(); i++ )
+            lines += bands[i][l];
+    }
+
     return contourLines;
 }
+
+/*!
+   \brief Connect the segments of a contour level to polylines
+
+   contourLines() returns the contour lines of a level as independent
+   segments of 2 points. As the segments of neighboured cells share their
+   end points, they can be connected to polylines, what reduces the
+   number of points to be stored and painted to the half and allows
+   to paint each line with one drawPolyline() call ( f.e. with
+   continuous dash patterns ).
+
+   The end points are joined using a hash table, so the costs are O(n).
+   Chains are split at points, where more than 2 segments meet.
+
+   \param lines Segments, as returned from contourLines() for one level
+   \return Connected polylines. Closed lines end with their first point.
+
+   \sa contourLines(), QwtPlotSpectrogram::drawContourLines()
+ */
+QVector< QPolygonF > QwtRasterData::connectedContourLines( const QPolygonF& lines )
+{
+    const int numEnds = lines.size() & ~1;
+    const QPointF* points = lines.constData();
+
+    // the end of another segment at the same position, or -1
+    QVector< int > partners( numEnds, -1 );
+
+    // segments of zero length are invisible and would break the chains
+    QBitArray done( numEnds / 2, false );
+
+    QHash< PointKey, int > ends;
+    ends.reserve( numEnds );
+
+    for ( int i = 0; i < numEnds; i++ )
+    {
+        if ( points[i & ~1] == points[i | 1] )
+        {
+            done.setBit( i / 2 );
+            continue;
+        }
+
+        const PointKey key( points[i] );
+
+        QHash< PointKey, int >::iterator it = ends.find( key );
+        if ( it == ends.end() )
+        {
+            ends.insert( key, i );
+        }
+        else if ( it.value() >= 0 )
+        {
+            if ( partners[ it.value() ] < 0 )
+            {
+                partners[ it.value() ] = i;
+                partners[i] = it.value();
+            }
+            else
+            {
+                // more than 2 segments meet: no unique way to continue
+                partners[ partners[ it.value() ] ] = -1;
+                partners[ it.value() ] = -1;
+
+                it.value() = -1;
+            }
+        }
+    }
+
+    QVector< QPolygonF > polylines;
+
+    /*
+        In the first pass we start at the open ends of the chains,
+        in the second pass the remaining segments are closed lines.
+     */
+    for ( int pass = 0; pass < 2; pass++ )
+    {
+        for ( int i = 0; i < numEnds; i++ )
+        {
+            if ( done.testBit( i / 2 ) || ( pass == 0 && partners[i] >= 0 ) )
+                continue;
+
+            QPolygonF polyline;
+            polyline += points[i];
+
+            int end = i;
+            while ( end >= 0 && !done.testBit( end / 2 ) )
+            {
+                done.setBit( end / 2 );
+
+                const int other = end ^ 1;
+                polyline += points[other];
+
+                end = partners[other];
+            }
+
+            polylines += polyline;
+        }
+    }
+
+    return polylines;
+}
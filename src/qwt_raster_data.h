@@ -18,6 +18,7 @@ class QPolygonF;
 class QRectF;
 class QSize;
 template< typename T > class QList;
+template< typename T > class QVector;
 template< class Key, class T > class QMap;
 
 /*!
@@ -80,7 +81,15 @@ class QWT_EXPORT QwtRasterData
         IgnoreAllVerticesOnLevel = 0x01,
 
         //! Ignore all values, that are out of range
-        IgnoreOutOfRange = 0x02
+        IgnoreOutOfRange = 0x02,
+
+        /*!
+           Paint the contour lines as connected polylines instead
+           of independent segments
+
+           \sa connectedContourLines(), QwtPlotSpectrogram::drawContourLines()
+         */
+        ConnectLines = 0x04
     };
 
     Q_DECLARE_FLAGS( ConrecFlags, ConrecFlag )
@@ -109,16 +118,27 @@ class QWT_EXPORT QwtRasterData
      */
     virtual double value( double x, double y ) const = 0;
 
+    virtual void values( const double* xValues, int numColumns,
+        const double* yValues, int numRows, double* values ) const;
+
+    virtual void pointValues( const double* xValues, const double* yValues,
+        int numPoints, double* values ) const;
+
     virtual ContourLines contourLines( const QRectF& rect,
         const QSize& raster, const QList< double >& levels,
         ConrecFlags ) const;
 
+    static QVector< QPolygonF > connectedContourLines( const QPolygonF& );
+
     class Contour3DPoint;
     class ContourPlane;
 
   private:
     Q_DISABLE_COPY(QwtRasterData)
 
+    friend class QwtPlotSpectrogram;
+    void setContourThreadCount( uint numThreads );
+
     class PrivateData;
     PrivateData* m_data;
 };
@@ -0,0 +1,413 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_ring_buffer_series_data.h"
+#include "qwt_math.h"
+
+#include <qatomic.h>
+#include <functional>
+#include <climits>
+
+namespace
+{
+    /*
+       Sliding window minimum ( or maximum ): the queue contains
+       only those values, that might become the extremum of the
+       window, once older values have been dropped. So the
+       values of the queue are monotonic and the front is
+       the extremum of the window.
+     */
+    template< class Compare >
+    class MonotonicQueue
+    {
+      public:
+        MonotonicQueue()
+            : m_first( 0 )
+            , m_count( 0 )
+        {
+        }
+
+        void reset( int capacity )
+        {
+            m_entries.resize( capacity );
+            clear();
+        }
+
+        void clear()
+        {
+            m_first = m_count = 0;
+        }
+
+        inline bool isEmpty() const
+        {
+            return m_count == 0;
+        }
+
+        inline double front() const
+        {
+            return m_entries[m_first].value;
+        }
+
+        inline void push( quint64 index, double value )
+        {
+            const Compare compare;
+
+            while ( m_count > 0 && !compare( entry( m_count - 1 ).value, value ) )
+                m_count--;
+
+            Entry& e = entry( m_count++ );
+            e.index = index;
+            e.value = value;
+        }
+
+        inline void expire( quint64 firstIndex )
+        {
+            while ( m_count > 0 && m_entries[m_first].index < firstIndex )
+            {
+                if ( ++m_first == m_entries.size() )
+                    m_first = 0;
+
+                m_count--;
+            }
+        }
+
+      private:
+        class Entry
+        {
+          public:
+            quint64 index;
+            double value;
+        };
+
+        inline Entry& entry( int pos )
+        {
+            pos += m_first;
+            if ( pos >= m_entries.size() )
+                pos -= m_entries.size();
+
+            return m_entries[pos];
+        }
+
+        QVector< Entry > m_entries;
+        int m_first;
+        int m_count;
+    };
+}
+
+class QwtRingBufferSeriesData::PrivateData
+{
+  public:
+    PrivateData( int capacity )
+        : capacity( qMax( capacity, 1 ) )
+        , written( 0 )
+        , published( 0 )
+        , synchronized( 0 )
+        , revision( 0 )
+        , counter( 0 )
+        , firstSlot( 0 )
+        , size( 0 )
+    {
+        /*
+            The samples of the last synchronization stay valid
+            until the producer has appended another capacity
+            of samples.
+         */
+        samples.resize( 2 * this->capacity );
+
+        minX.reset( this->capacity );
+        maxX.reset( this->capacity );
+        minY.reset( this->capacity );
+        maxY.reset( this->capacity );
+    }
+
+    inline int slot( quint64 index ) const
+    {
+        return int( index % quint64( samples.size() ) );
+    }
+
+    inline void takeOver( quint64 index )
+    {
+        const QPointF& point = samples[ slot( index ) ];
+
+        // the queues never hold more than capacity entries
+        const quint64 first = index + 1 - qMin( index + 1, quint64( capacity ) );
+
+        if ( !qIsNaN( point.x() ) )
+        {
+            minX.expire( first );
+            minX.push( index, point.x() );
+
+            maxX.expire( first );
+            maxX.push( index, point.x() );
+        }
+
+        if ( !qIsNaN( point.y() ) )
+        {
+            minY.expire( first );
+            minY.push( index, point.y() );
+
+            maxY.expire( first );
+            maxY.push( index, point.y() );
+        }
+    }
+
+    const int capacity;
+    QVector< QPointF > samples;
+
+    // producer thread
+    quint64 written;
+
+    // the lower 32 bits of written, when being published
+    QAtomicInt published;
+
+    // consumer thread
+    quint64 synchronized;
+    quint64 revision;
+    int counter;
+
+    int firstSlot;
+    int size;
+
+    MonotonicQueue< std::less< double > > minX;
+    MonotonicQueue< std::greater< double > > maxX;
+    MonotonicQueue< std::less< double > > minY;
+    MonotonicQueue< std::greater< double > > maxY;
+
+    QRectF boundingRect;
+};
+
+/*!
+   Constructor
+
+   \param capacity Maximum number of samples
+ */
+QwtRingBufferSeriesData::QwtRingBufferSeriesData( int capacity )
+{
+    m_data = new PrivateData( capacity );
+    cachedBoundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+}
+
+//! Destructor
+QwtRingBufferSeriesData::~QwtRingBufferSeriesData()
+{
+    delete m_data;
+}
+
+//! \return Maximum number of samples
+int QwtRingBufferSeriesData::capacity() const
+{
+    return m_data->capacity;
+}
+
+/*!
+   \brief Append a sample
+
+   When the buffer is full the oldest sample gets overwritten.
+   The sample will be visible after the next synchronize().
+
+   \param point Sample
+   \note append() is intended to be called from the producer thread only
+ */
+void QwtRingBufferSeriesData::append( const QPointF& point )
+{
+    m_data->samples[ m_data->slot( m_data->written ) ] = point;
+    m_data->written++;
+
+    m_data->published.fetchAndStoreRelease( int( m_data->written ) );
+}
+
+/*!
+   \brief Append an array of samples
+
+   \param points Array of samples
+   \param numPoints Number of samples
+
+   \note append() is intended to be called from the producer thread only
+ */
+void QwtRingBufferSeriesData::append( const QPointF* points, int numPoints )
+{
+    if ( numPoints <= 0 )
+        return;
+
+    QPointF* samples = m_data->samples.data();
+    const int bufferSize = m_data->samples.size();
+
+    if ( numPoints > bufferSize )
+    {
+        // the leading samples would be overwritten anyway
+        points += numPoints - bufferSize;
+        m_data->written += numPoints - bufferSize;
+
+        numPoints = bufferSize;
+    }
+
+    int slot = m_data->slot( m_data->written );
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        samples[slot] = points[i];
+        if ( ++slot == bufferSize )
+            slot = 0;
+    }
+
+    m_data->written += numPoints;
+    m_data->published.fetchAndStoreRelease( int( m_data->written ) );
+}
+
+/*!
+   \brief Take over the samples, that have been appended since the
+          last synchronization
+
+   synchronize() updates size(), sample() and boundingRect(). Between
+   two calls of synchronize() the series does not change, so it
+   needs to be called before replotting and never while being painted.
+
+   \return Number of samples, that have been appended since the last call
+   \note synchronize() is intended to be called from the consumer thread only
+ */
+int QwtRingBufferSeriesData::synchronize()
+{
+    const int counter = m_data->published.fetchAndAddAcquire( 0 );
+
+    // the difference of the lower 32 bits survives a wraparound
+    const quint32 numAppended = quint32( counter ) - quint32( m_data->counter );
+
+    m_data->counter = counter;
+
+    if ( numAppended == 0 )
+        return 0;
+
+    const quint64 last = m_data->synchronized + numAppended;
+    const quint64 first = ( last > quint64( m_data->capacity ) )
+        ? last - m_data->capacity : 0;
+
+    /*
+        When more than the capacity of samples have been appended
+        only the most recent ones need to be taken over.
+     */
+    const quint64 from = qMax( m_data->synchronized, first );
+    if ( from != m_data->synchronized )
+    {
+        m_data->minX.clear();
+        m_data->maxX.clear();
+        m_data->minY.clear();
+        m_data->maxY.clear();
+    }
+
+    for ( quint64 index = from; index < last; index++ )
+        m_data->takeOver( index );
+
+    m_data->minX.expire( first );
+    m_data->maxX.expire( first );
+    m_data->minY.expire( first );
+    m_data->maxY.expire( first );
+
+    m_data->synchronized = last;
+    m_data->revision += numAppended;
+
+    m_data->firstSlot = m_data->slot( first );
+    m_data->size = int( last - first );
+
+    QRectF& rect = m_data->boundingRect;
+    if ( m_data->minX.isEmpty() || m_data->minY.isEmpty() )
+    {
+        rect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+    }
+    else
+    {
+        rect.setCoords( m_data->minX.front(), m_data->minY.front(),
+            m_data->maxX.front(), m_data->maxY.front() );
+    }
+
+    cachedBoundingRect = rect;
+
+    return int( qMin( numAppended, quint32( INT_MAX ) ) );
+}
+
+/*!
+   \brief Remove all samples
+
+   \warning clear() modifies the state of the producer and must not
+            be called while another thread is appending samples.
+ */
+void QwtRingBufferSeriesData::clear()
+{
+    m_data->written = 0;
+    m_data->published.fetchAndStoreRelease( 0 );
+
+    m_data->synchronized = 0;
+    m_data->counter = 0;
+    m_data->firstSlot = 0;
+    m_data->size = 0;
+
+    m_data->minX.clear();
+    m_data->maxX.clear();
+    m_data->minY.clear();
+    m_data->maxY.clear();
+
+    m_data->boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+    cachedBoundingRect = m_data->boundingRect;
+}
+
+/*!
+   \return Number of samples of the last synchronization
+   \sa synchronize()
+ */
+size_t QwtRingBufferSeriesData::size() const
+{
+    return m_data->size;
+}
+
+/*!
+   \return Sample of the last synchronization
+   \param index Index, where 0 is the oldest sample
+
+   \sa synchronize()
+ */
+QPointF QwtRingBufferSeriesData::sample( size_t index ) const
+{
+    int slot = m_data->firstSlot + int( index );
+    if ( slot >= m_data->samples.size() )
+        slot -= m_data->samples.size();
+
+    return m_data->samples[slot];
+}
+
+/*!
+   \return Bounding rectangle of the samples of the last synchronization
+   \sa synchronize()
+ */
+QRectF QwtRingBufferSeriesData::boundingRect() const
+{
+    return m_data->boundingRect;
+}
+
+/*!
+   \return Pointer to the samples, when the samples of the last
+           synchronization do not wrap around the end of the
+           ring buffer. Otherwise NULL.
+ */
+const QPointF* QwtRingBufferSeriesData::contiguousSamples() const
+{
+    if ( m_data->firstSlot + m_data->size > m_data->samples.size() )
+        return NULL;
+
+    return m_data->samples.constData() + m_data->firstSlot;
+}
+
+/*!
+   \return Number of samples, that have been taken over by synchronize()
+           since the series has been created
+
+   The revision is not reset by clear().
+   \sa synchronize(), QwtSeriesData::revision()
+ */
+quint64 QwtRingBufferSeriesData::revision() const
+{
+    return m_data->revision;
+}
@@ -0,0 +1,111 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_RING_BUFFER_SERIES_DATA_H
+#define QWT_RING_BUFFER_SERIES_DATA_H
+
+#include "qwt_global.h"
+#include "qwt_series_data.h"
+
+/*!
+   \brief A series of the most recent points of an acquisition
+
+   QwtRingBufferSeriesData is a series with a fixed capacity, that is
+   intended for displaying the most recent samples of a signal, that
+   is sampled in another thread - f.e. by a QwtSamplingThread.
+
+   - append()\n
+     Samples are appended by one producer thread without any locking.
+     When the buffer is full the oldest samples get overwritten.
+
+   - synchronize()\n
+     Has to be called from the GUI thread before replotting.
+     It takes over the samples, that have been appended since the
+     previous call. size(), sample() and boundingRect() always refer to
+     the state of the last synchronization, so that the series
+     does not change while being painted.
+
+   The samples are read from the memory of the ring buffer without being
+   copied. To protect the samples of the last synchronization from being
+   overwritten while they are painted, the buffer has memory for
+   twice the capacity.
+
+   As the size does not change anymore, once the buffer is full,
+   revision() counts the samples, that have been taken over
+   by synchronize(). It never decreases - not even by clear() -
+   so that caches keyed on the revision are invalidated reliably.
+
+   The bounding rectangle is maintained with monotonic queues of the
+   minima and maxima, what costs O(1) amortized for each sample
+   and never needs to iterate over the complete series.
+
+   \par Example
+   \code
+ #include <qwt_ring_buffer_series_data.h>
+ #include <qwt_sampling_thread.h>
+
+    class SamplingThread : public QwtSamplingThread
+    {
+      public:
+        SamplingThread( QwtRingBufferSeriesData* data )
+            : m_data( data )
+        {
+        }
+
+      protected:
+        virtual void sample( double elapsed )
+        {
+            m_data->append( QPointF( elapsed, readValue() ) );
+        }
+
+      private:
+        QwtRingBufferSeriesData* m_data;
+    };
+
+    // GUI thread, f.e. in a timer event
+    if ( data->synchronize() > 0 )
+        plot->replot();
+   \endcode
+
+   \note The series must not be shared between more than one producer
+         and one consumer thread.
+
+   \sa QwtSamplingThread, QwtPlotDirectPainter
+ */
+class QWT_EXPORT QwtRingBufferSeriesData : public QwtSeriesData< QPointF >
+{
+  public:
+    explicit QwtRingBufferSeriesData( int capacity );
+    virtual ~QwtRingBufferSeriesData();
+
+    int capacity() const;
+
+    void append( const QPointF& );
+    void append( const QPointF* points, int numPoints );
+
+    int synchronize();
+    void clear();
+
+    virtual size_t size() const QWT_OVERRIDE;
+    virtual QPointF sample( size_t index ) const QWT_OVERRIDE;
+
+    virtual QRectF boundingRect() const QWT_OVERRIDE;
+
+    virtual const QPointF* contiguousSamples() const QWT_OVERRIDE;
+
+    virtual quint64 revision() const QWT_OVERRIDE;
+
+  private:
+    Q_DISABLE_COPY( QwtRingBufferSeriesData )
+
+    class PrivateData;
+    PrivateData* m_data;
+};
+
+#endif
@@ -106,6 +106,62 @@ class QwtSeriesData
      */
     virtual void setRectOfInterest( const QRectF& rect );
 
+    /*!
+       \brief Direct access to samples stored in contiguous memory
+
+       Implementations, that store their samples in an array might return
+       a pointer to the first sample. Then algorithms like the ones of
+       QwtPointMapper are able to iterate over the samples without
+       calling sample() for each of them.
+
+       The default implementation returns NULL.
+
+       \return Pointer to the first sample, or NULL
+       \sa contiguousValues()
+     */
+    virtual const T* contiguousSamples() const;
+
+    /*!
+       \brief Direct access to x and y coordinates stored in contiguous memory
+
+       Implementations, that store the coordinates of their samples
+       in two separate arrays of doubles might return pointers to
+       the first elements of these arrays.
+
+       The default implementation returns false.
+
+       \param xValues Return parameter for the x coordinates
+       \param yValues Return parameter for the y coordinates
+
+       \return true, when the coordinates are available
+       \sa contiguousSamples()
+     */
+    virtual bool contiguousValues(
+        const double** xValues, const double** yValues ) const;
+
+    /*!
+       \brief Revision of the samples
+
+       The revision changes, whenever the samples have been modified.
+       It allows to detect modifications of series, that are not
+       indicated by a different size - f.e. a ring buffer, that
+       is full.
+
+       For series, where samples are only appended, the difference
+       between two revisions has to be the number of samples, that have
+       been appended in between ( see QwtPlotCurve::AppendOnly ).
+       Any other modification has to increase the revision by more
+       than the number of samples.
+
+       The default implementation returns size(). Series, that modify
+       their samples without changing the size - f.e. in
+       setRectOfInterest() - have to override it.
+
+       \return Revision of the samples
+       \sa QwtRingBufferSeriesData::revision()
+     */
+    virtual quint64 revision() const;
+
   protected:
     //! Can be used to cache a calculated bounding rectangle
     mutable QRectF cachedBoundingRect;
@@ -130,6 +186,25 @@ void QwtSeriesData< T >::setRectOfInterest( const QRectF& )
 {
 }
 
+template< typename T >
+const T* QwtSeriesData< T >::contiguousSamples() const
+{
+    return NULL;
+}
+
+template< typename T >
+bool QwtSeriesData< T >::contiguousValues(
+    const double**, const double** ) const
+{
+    return false;
+}
+
+template< typename T >
+quint64 QwtSeriesData< T >::revision() const
+{
+    return size();
+}
+
 /*!
    \brief Template class for data, that is organized as QVector
 
@@ -169,6 +244,9 @@ class QwtArraySeriesData : public QwtSeriesData< T >
      */
     virtual T sample( size_t index ) const QWT_OVERRIDE;
 
+    //! \return Pointer to the first sample
+    virtual const T* contiguousSamples() const QWT_OVERRIDE;
+
   protected:
     //! Vector of samples
     QVector< T > m_samples;
@@ -210,6 +288,12 @@ T QwtArraySeriesData< T >::sample( size_t i ) const
     return m_samples[ static_cast< int >( i ) ];
 }
 
+template< typename T >
+const T* QwtArraySeriesData< T >::contiguousSamples() const
+{
+    return m_samples.constData();
+}
+
 //! Interface for iterating over an array of points
 typedef QwtArraySeriesData< QPointF > QwtPointSeriesData;
 
@@ -14,6 +14,8 @@
 
 #include <qpainterpath.h>
 
+#include <climits>
+
 namespace QwtSplineC1P
 {
     struct param
@@ -386,35 +388,85 @@ static inline SplineStore qwtSplineC1PathParametric(
     return store;
 }
 
+static inline int qwtEstimatedPolygonSize( double length, double distance, int numNodes )
+{
+    const double size = length / distance;
+    if ( !( size >= 0.0 && size < 0.25 * INT_MAX ) )
+        return numNodes;
+
+    return static_cast< int >( size ) + numNodes;
+}
+
+static inline QwtSplinePolynomial qwtBezierPolynomial(
+    double p1, double cp1, double cp2, double p2 )
+{
+    // the Bezier curve in power basis
+    return QwtSplinePolynomial( p2 - p1 + 3.0 * ( cp1 - cp2 ),
+        3.0 * ( p1 - 2.0 * cp1 + cp2 ), 3.0 * ( cp1 - p1 ) );
+}
+
 template< QwtSplinePolynomial toPolynomial( const QPointF&, double, const QPointF&, double ) >
 static QPolygonF qwtPolygonParametric( double distance,
     const QPolygonF& points, const QVector< double >& values, bool withNodes )
 {
-    QPolygonF fittedPoints;
-
     const QPointF* p = points.constData();
     const double* v = values.constData();
 
-    fittedPoints += p[0];
-    double t = distance;
-
     const int n = points.size();
 
+    /*
+        Collecting the polynomials and the parameters first, so
+        that the polynomials can be evaluated in one batch
+     */
+    QVector< QwtSplinePolynomial > polynomials( n - 1 );
+    QVector< int > offsets( n );
+
+    QVector< double > params;
+    params.reserve( qwtEstimatedPolygonSize(
+        p[n - 1].x() - p[0].x(), distance, 0 ) );
+
+    double t = distance;
+
     for ( int i = 0; i < n - 1; i++ )
     {
         const QPointF& p1 = p[i];
         const QPointF& p2 = p[i + 1];
 
-        const QwtSplinePolynomial polynomial = toPolynomial( p1, v[i], p2, v[i + 1] );
+        polynomials[i] = toPolynomial( p1, v[i], p2, v[i + 1] );
+        offsets[i] = params.size();
 
         const double l = p2.x() - p1.x();
 
         while ( t < l )
         {
-            fittedPoints += QPointF( p1.x() + t, p1.y() + polynomial.valueAt( t ) );
+            params += t;
             t += distance;
         }
 
+        if ( !withNodes )
+            t -= l;
+    }
+
+    offsets[n - 1] = params.size();
+
+    QVector< double > y( params.size() );
+
+    QwtSplinePolynomial::valuesAt( polynomials.constData(), n - 1,
+        offsets.constData(), params.constData(), y.data() );
+
+    QPolygonF fittedPoints;
+    fittedPoints.reserve( params.size() + n );
+
+    fittedPoints += p[0];
+
+    for ( int i = 0; i < n - 1; i++ )
+    {
+        const QPointF& p1 = p[i];
+        const QPointF& p2 = p[i + 1];
+
+        for ( int j = offsets[i]; j < offsets[i + 1]; j++ )
+            fittedPoints += QPointF( p1.x() + params[j], p1.y() + y[j] );
+
         if ( withNodes )
         {
             if ( qFuzzyCompare( fittedPoints.last().x(), p2.x() ) )
@@ -422,10 +474,6 @@ static QPolygonF qwtPolygonParametric( double distance,
             else
                 fittedPoints += p2;
         }
-        else
-        {
-            t -= l;
-        }
     }
 
     return fittedPoints;
@@ -876,65 +924,99 @@ QPolygonF QwtSplineInterpolating::equidistantPolygon( const QPolygonF& points,
         return points;
     }
 
-    QPolygonF path;
-
     const QVector< QLineF > controlLines = bezierControlLines( points );
 
     if ( controlLines.size() < n - 1 )
-        return path;
+        return QPolygonF();
 
-    path += points.first();
-    double t = distance;
+    const bool isClosing = ( boundaryType() == QwtSpline::ClosedPolygon )
+        && ( controlLines.size() >= n );
+
+    const int numSegments = isClosing ? n : n - 1;
 
     const QPointF* p = points.constData();
     const QLineF* cl = controlLines.constData();
 
     const QwtSplineParametrization* param = parametrization();
 
-    for ( int i = 0; i < n - 1; i++ )
+    /*
+        Collecting the Bezier curves - translated into polynomials - and
+        their parameters first, so that they can be evaluated in one batch
+     */
+
+    QVector< QwtSplinePolynomial > polynomialsX( numSegments );
+    QVector< QwtSplinePolynomial > polynomialsY( numSegments );
+    QVector< int > offsets( numSegments + 1 );
+
+    QVector< double > params;
+    double length = 0.0;
+
+    for ( int i = 0; i < numSegments; i++ )
+        length += param->valueIncrement( p[i], p[ ( i + 1 ) % n ] );
+
+    params.reserve( qwtEstimatedPolygonSize( length, distance, 0 ) );
+
+    double t = distance;
+
+    for ( int i = 0; i < numSegments; i++ )
     {
-        const double l = param->valueIncrement( p[i], p[i + 1] );
+        const QPointF& p1 = p[i];
+        const QPointF& p2 = p[ ( i + 1 ) % n ];
+        const QLineF& l = cl[i];
 
-        while ( t < l )
-        {
-            path += QwtBezier::pointAt( p[i], cl[i].p1(),
-                cl[i].p2(), p[i + 1], t / l );
+        polynomialsX[i] = qwtBezierPolynomial(
+            p1.x(), l.p1().x(), l.p2().x(), p2.x() );
+
+        polynomialsY[i] = qwtBezierPolynomial(
+            p1.y(), l.p1().y(), l.p2().y(), p2.y() );
+
+        offsets[i] = params.size();
+
+        const double dt = param->valueIncrement( p1, p2 );
 
+        while ( t < dt )
+        {
+            params += t / dt;
             t += distance;
         }
 
         if ( withNodes )
-        {
-            if ( qFuzzyCompare( path.last().x(), p[i + 1].x() ) )
-                path.last() = p[i + 1];
-            else
-                path += p[i + 1];
-
             t = distance;
-        }
         else
-        {
-            t -= l;
-        }
+            t -= dt;
     }
 
-    if ( ( boundaryType() == QwtSpline::ClosedPolygon )
-        && ( controlLines.size() >= n ) )
+    offsets[numSegments] = params.size();
+
+    QVector< double > x( params.size() );
+    QVector< double > y( params.size() );
+
+    QwtSplinePolynomial::valuesAt( polynomialsX.constData(), numSegments,
+        offsets.constData(), params.constData(), x.data() );
+
+    QwtSplinePolynomial::valuesAt( polynomialsY.constData(), numSegments,
+        offsets.constData(), params.constData(), y.data() );
+
+    QPolygonF path;
+    path.reserve( params.size() + n + 1 );
+
+    path += points.first();
+
+    for ( int i = 0; i < numSegments; i++ )
     {
-        const double l = param->valueIncrement( p[n - 1], p[0] );
+        const QPointF& p1 = p[i];
+        const QPointF& p2 = p[ ( i + 1 ) % n ];
 
-        while ( t < l )
-        {
-            path += QwtBezier::pointAt( p[n - 1], cl[n - 1].p1(),
-                cl[n - 1].p2(), p[0], t / l );
+        for ( int j = offsets[i]; j < offsets[i + 1]; j++ )
+            path += QPointF( p1.x() + x[j], p1.y() + y[j] );
 
-            t += distance;
+        if ( withNodes || i == n - 1 )
+        {
+            if ( qFuzzyCompare( path.last().x(), p2.x() ) )
+                path.last() = p2;
+            else
+                path += p2;
         }
-
-        if ( qFuzzyCompare( path.last().x(), p[0].x() ) )
-            path.last() = p[0];
-        else
-            path += p[0];
     }
 
     return path;
@@ -10,9 +10,46 @@
 #include "qwt_spline_curve_fitter.h"
 #include "qwt_spline_local.h"
 #include "qwt_spline_parametrization.h"
+#include "qwt_clipper.h"
 
 #include <qpolygon.h>
 #include <qpainterpath.h>
+#include <qline.h>
+
+/*
+   The curve between the points i and i + 1 depends on the points
+   i - locality to i + 1 + locality only. As the curve might swing
+   out of the bounding rectangle of these points, it is expanded by
+   its own size, what is a conservative guess for the local
+   splines being implemented.
+ */
+static bool qwtIsSegmentVisible( const QPointF* points, int numPoints,
+    int index, int locality, const QRectF& clipRect )
+{
+    const int from = qMax( index - locality, 0 );
+    const int to = qMin( index + 1 + locality, numPoints - 1 );
+
+    double minX = points[from].x();
+    double maxX = minX;
+    double minY = points[from].y();
+    double maxY = minY;
+
+    for ( int i = from + 1; i <= to; i++ )
+    {
+        const QPointF& p = points[i];
+
+        minX = qMin( minX, p.x() );
+        maxX = qMax( maxX, p.x() );
+        minY = qMin( minY, p.y() );
+        maxY = qMax( maxY, p.y() );
+    }
+
+    const double dx = maxX - minX;
+    const double dy = maxY - minY;
+
+    return ( maxX + dx >= clipRect.left() ) && ( minX - dx <= clipRect.right() )
+        && ( maxY + dy >= clipRect.top() ) && ( minY - dy <= clipRect.bottom() );
+}
 
 //! Constructor
 QwtSplineCurveFitter::QwtSplineCurveFitter()
@@ -100,3 +137,96 @@ QPainterPath QwtSplineCurveFitter::fitCurvePath( const QPolygonF& points ) const
 
     return path;
 }
+
+/*!
+   Find a curve path which has the best fit to a series of data points
+   inside of a clip rectangle
+
+   For splines with a locality() > 0 and conditional boundaries
+   the spline is calculated for the visible segments of the polygon
+   only. As each of these segments is calculated from the same neighbours
+   as before the result does not differ inside of the clip rectangle.
+
+   For all other splines the polygon is clipped before the curve is fitted.
+
+   \param points Series of data points
+   \param clipRect Clip rectangle
+   \return Fitted Curve
+
+   \sa QwtSpline::locality(), QwtPlotCurve::ClipPolygons
+ */
+QPainterPath QwtSplineCurveFitter::fitCurvePath(
+    const QPolygonF& points, const QRectF& clipRect ) const
+{
+    if ( m_spline == NULL )
+        return QPainterPath();
+
+    const int locality = static_cast< int >( m_spline->locality() );
+    const int n = points.size();
+
+    if ( locality == 0 || n <= 2 * locality + 2
+        || m_spline->boundaryType() != QwtSpline::ConditionalBoundaries )
+    {
+        QPolygonF polygon = points;
+        QwtClipper::clipPolygonF( clipRect, polygon, false );
+
+        return fitCurvePath( polygon );
+    }
+
+    const QwtSplineInterpolating* interpolatingSpline =
+        dynamic_cast< const QwtSplineInterpolating* >( m_spline );
+
+    const QPointF* p = points.constData();
+
+    QPainterPath path;
+
+    int i = 0;
+    while ( i < n - 1 )
+    {
+        if ( !qwtIsSegmentVisible( p, n, i, locality, clipRect ) )
+        {
+            i++;
+            continue;
+        }
+
+        /*
+            Collecting a range of visible segments. Invisible
+            segments in between are included, as long as the ranges
+            of the neighbours would overlap.
+         */
+        const int first = i;
+        int last = i;
+
+        for ( i++; i < n - 1; i++ )
+        {
+            if ( qwtIsSegmentVisible( p, n, i, locality, clipRect ) )
+                last = i;
+            else if ( i - last > 2 * locality + 1 )
+                break;
+        }
+
+        const int from = qMax( first - locality, 0 );
+        const int to = qMin( last + 1 + locality, n - 1 );
+
+        const QPolygonF polygon = points.mid( from, to - from + 1 );
+
+        const QVector< QLineF > controlLines = interpolatingSpline
+            ? interpolatingSpline->bezierControlLines( polygon ) : QVector< QLineF >();
+
+        if ( controlLines.size() >= polygon.size() - 1 )
+        {
+            // leaving out the segments, that have been added for the neighbours
+            const QLineF* l = controlLines.constData();
+
+            path.moveTo( p[first] );
+            for ( int j = first; j <= last; j++ )
+                path.cubicTo( l[j - from].p1(), l[j - from].p2(), p[j + 1] );
+        }
+        else
+        {
+            path.addPath( m_spline->painterPath( polygon ) );
+        }
+    }
+
+    return path;
+}
@@ -13,6 +13,7 @@
 #include "qwt_curve_fitter.h"
 
 class QwtSpline;
+class QRectF;
 
 /*!
    \brief A curve fitter using a spline interpolation
@@ -20,6 +21,12 @@ class QwtSpline;
    The default setting for the spline is a cardinal spline with
    uniform parametrization.
 
+   For splines with a locality() > 0 only the points of the visible
+   area - and a couple of neighbours - have an effect on the visible part
+   of the curve. In this case fitCurvePath( const QPolygonF&, const QRectF& )
+   fits the visible parts only, what makes a difference for curves with
+   many points, when zooming in.
+
    \sa QwtSpline, QwtSplineLocal
  */
 class QWT_EXPORT QwtSplineCurveFitter : public QwtCurveFitter
@@ -36,6 +43,8 @@ class QWT_EXPORT QwtSplineCurveFitter : public QwtCurveFitter
     virtual QPolygonF fitCurve( const QPolygonF& ) const QWT_OVERRIDE;
     virtual QPainterPath fitCurvePath( const QPolygonF& ) const QWT_OVERRIDE;
 
+    QPainterPath fitCurvePath( const QPolygonF&, const QRectF& clipRect ) const;
+
   private:
     QwtSpline* m_spline;
 };
@@ -19,6 +19,44 @@ namespace
     } qwtRegisterQwtSplinePolynomial;
 }
 
+/*!
+   \brief Calculate the values of polynomials for arrays of parameters
+
+   The polynomial polynomials[i] is evaluated for the parameters
+   x[offsets[i]] to x[offsets[i+1] - 1]. The values are written to the same
+   positions of values, that has to be allocated by the caller.
+
+   As the values of each polynomial are calculated in a loop without
+   dependencies between the iterations, the Horner scheme can be
+   vectorized by the compiler.
+
+   \param polynomials Array of polynomials
+   \param numPolynomials Number of polynomials
+   \param offsets Array of numPolynomials + 1 offsets into x and values
+   \param x Array of parameters
+   \param values Array for the calculated values
+
+   \sa valueAt()
+ */
+void QwtSplinePolynomial::valuesAt( const QwtSplinePolynomial* polynomials,
+    int numPolynomials, const int* offsets, const double* x, double* values )
+{
+    for ( int i = 0; i < numPolynomials; i++ )
+    {
+        const double c3 = polynomials[i].c3;
+        const double c2 = polynomials[i].c2;
+        const double c1 = polynomials[i].c1;
+
+        const int to = offsets[i + 1];
+
+        for ( int j = offsets[i]; j < to; j++ )
+        {
+            const double t = x[j];
+            values[j] = ( ( c3 * t + c2 ) * t + c1 ) * t;
+        }
+    }
+}
+
 #ifndef QT_NO_DEBUG_STREAM
 
 #include <qdebug.h>
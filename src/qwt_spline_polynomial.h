@@ -53,6 +53,9 @@ class QWT_EXPORT QwtSplinePolynomial
     static QwtSplinePolynomial fromCurvatures(
         double dx, double dy, double cv1, double cv2 );
 
+    static void valuesAt( const QwtSplinePolynomial* polynomials,
+        int numPolynomials, const int* offsets, const double* x, double* values );
+
   public:
     //! coefficient of the cubic summand
     double c3;
@@ -0,0 +1,411 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_streaming_histogram_data.h"
+#include "qwt_math.h"
+
+#include <qatomic.h>
+
+#if QT_VERSION >= 0x050300
+typedef QAtomicInteger< qint64 > QwtHistogramCounter;
+#else
+// no 64 bit atomics before Qt 5.3
+typedef QAtomicInt QwtHistogramCounter;
+#endif
+
+class QwtStreamingHistogramData::PrivateData
+{
+  public:
+    PrivateData( const QwtInterval& interval, int numBins,
+            QwtStreamingHistogramData::BinMode binMode )
+        : interval( interval.normalized() )
+        , numBins( qMax( numBins, 1 ) )
+        , binMode( binMode )
+        , scale( 0.0 )
+        , totals( NULL )
+        , windowLength( 0.0 )
+        , numSlices( 0 )
+        , slices( NULL )
+        , currentSlot( 0 )
+        , currentSlice( 0 )
+        , hasSlice( false )
+        , appended( 0 )
+        , boundingRect( 0.0, 0.0, -1.0, -1.0 )
+    {
+        const double min = this->interval.minValue();
+        const double max = this->interval.maxValue();
+
+        if ( binMode == QwtStreamingHistogramData::LogarithmicBins )
+        {
+            if ( min > 0.0 && max > min )
+                scale = this->numBins / std::log( max / min );
+        }
+        else
+        {
+            if ( max > min )
+                scale = this->numBins / ( max - min );
+        }
+
+        totals = new QwtHistogramCounter[ this->numBins ];
+        counts.fill( 0, this->numBins );
+    }
+
+    ~PrivateData()
+    {
+        delete[] totals;
+        delete[] slices;
+    }
+
+    inline int binIndex( double value ) const
+    {
+        double f;
+
+        if ( binMode == QwtStreamingHistogramData::LogarithmicBins )
+        {
+            if ( !( value > 0.0 ) )
+                return -1;
+
+            f = std::log( value / interval.minValue() ) * scale;
+        }
+        else
+        {
+            f = ( value - interval.minValue() ) * scale;
+        }
+
+        // also sorting out NaNs
+        if ( !( f >= 0.0 && f <= numBins ) )
+            return -1;
+
+        // the maximum is included in the last bin
+        return qMin( int( f ), numBins - 1 );
+    }
+
+    inline double binBorder( int index ) const
+    {
+        if ( index >= numBins )
+            return interval.maxValue();
+
+        const double min = interval.minValue();
+
+        if ( binMode == QwtStreamingHistogramData::LogarithmicBins )
+            return min * std::exp( index / scale );
+
+        return min + index / scale;
+    }
+
+    // dropping the counts of a slice, that is not current anymore
+    void expireSlot( int slot )
+    {
+        QwtHistogramCounter* counters = slices + slot * numBins;
+
+        for ( int i = 0; i < numBins; i++ )
+        {
+            const qint64 count = counters[i].fetchAndStoreOrdered( 0 );
+            if ( count != 0 )
+                totals[i].fetchAndAddOrdered( -count );
+        }
+    }
+
+    const QwtInterval interval;
+    const int numBins;
+    const QwtStreamingHistogramData::BinMode binMode;
+
+    // number of bins for a unit of the interval ( or its logarithm )
+    double scale;
+
+    // counts of the complete window
+    QwtHistogramCounter* totals;
+
+    double windowLength;
+    int numSlices;
+
+    // counts of each slice of the window
+    QwtHistogramCounter* slices;
+    QAtomicInt currentSlot;
+
+    // only accessed by the thread calling synchronize()
+    qint64 currentSlice;
+    bool hasSlice;
+
+    QwtHistogramCounter appended;
+
+    // the state of the last synchronization
+    QVector< qint64 > counts;
+    QRectF boundingRect;
+};
+
+/*!
+   Constructor
+
+   \param interval Interval of the histogram. It is divided
+                  into numBins bins.
+   \param numBins Number of bins
+   \param binMode Width of the bins
+ */
+QwtStreamingHistogramData::QwtStreamingHistogramData(
+    const QwtInterval& interval, int numBins, BinMode binMode )
+{
+    m_data = new PrivateData( interval, numBins, binMode );
+}
+
+//! Destructor
+QwtStreamingHistogramData::~QwtStreamingHistogramData()
+{
+    delete m_data;
+}
+
+//! \return Interval of the histogram
+QwtInterval QwtStreamingHistogramData::interval() const
+{
+    return m_data->interval;
+}
+
+//! \return Number of bins
+int QwtStreamingHistogramData::numBins() const
+{
+    return m_data->numBins;
+}
+
+//! \return Width of the bins
+QwtStreamingHistogramData::BinMode QwtStreamingHistogramData::binMode() const
+{
+    return m_data->binMode;
+}
+
+/*!
+   \brief Count only the values of a sliding time window
+
+   The time window is divided into numSlices slices of the
+   length length / numSlices. The more slices the smoother the
+   window is moving, but the more expensive is synchronize().
+
+   setTimeWindow() resets all counts and must not be called,
+   while values are appended from other threads.
+
+   \param length Length of the window in the unit of the time
+                 values passed to synchronize().
+                 A length <= 0.0 disables the time window.
+   \param numSlices Number of slices
+
+   \sa timeWindow(), numSlices(), synchronize()
+ */
+void QwtStreamingHistogramData::setTimeWindow( double length, int numSlices )
+{
+    delete[] m_data->slices;
+    m_data->slices = NULL;
+
+    if ( length > 0.0 && numSlices > 0 )
+    {
+        m_data->windowLength = length;
+        m_data->numSlices = numSlices;
+        m_data->slices = new QwtHistogramCounter[ numSlices * m_data->numBins ];
+    }
+    else
+    {
+        m_data->windowLength = 0.0;
+        m_data->numSlices = 0;
+    }
+
+    m_data->hasSlice = false;
+    m_data->currentSlot.fetchAndStoreRelease( 0 );
+
+    clear();
+}
+
+/*!
+   \return Length of the time window, or 0.0 when all
+           values are counted
+   \sa setTimeWindow()
+ */
+double QwtStreamingHistogramData::timeWindow() const
+{
+    return m_data->windowLength;
+}
+
+/*!
+   \return Number of slices of the time window
+   \sa setTimeWindow()
+ */
+int QwtStreamingHistogramData::numSlices() const
+{
+    return m_data->numSlices;
+}
+
+/*!
+   \brief Count a value
+
+   append() can be called from any thread.
+
+   \param value Value
+   \sa synchronize()
+ */
+void QwtStreamingHistogramData::append( double value )
+{
+    const int bin = m_data->binIndex( value );
+    if ( bin < 0 )
+        return;
+
+    if ( m_data->slices )
+    {
+        const int slot = m_data->currentSlot.fetchAndAddAcquire( 0 );
+        m_data->slices[ slot * m_data->numBins + bin ].fetchAndAddRelaxed( 1 );
+    }
+
+    m_data->totals[bin].fetchAndAddRelaxed( 1 );
+    m_data->appended.fetchAndAddRelaxed( 1 );
+}
+
+/*!
+   \brief Count an array of values
+
+   append() can be called from any thread.
+
+   \param values Array of values
+   \param numValues Number of values
+   \sa synchronize()
+ */
+void QwtStreamingHistogramData::append( const double* values, int numValues )
+{
+    for ( int i = 0; i < numValues; i++ )
+        append( values[i] );
+}
+
+/*!
+   \brief Take over the counts of the bins
+
+   synchronize() has to be called from the GUI thread and updates the
+   samples, that are displayed. When a time window has been set,
+   the window is moved to time first.
+
+   \param time Current time in the unit of the time window.
+               Ignored, when no time window has been set.
+
+   \return Number of values, that have been counted since
+           the previous synchronization
+
+   \sa append(), setTimeWindow()
+ */
+qint64 QwtStreamingHistogramData::synchronize( double time )
+{
+    if ( m_data->slices )
+    {
+        const double sliceLength = m_data->windowLength / m_data->numSlices;
+        const qint64 slice = static_cast< qint64 >(
+            std::floor( time / sliceLength ) );
+
+        if ( !m_data->hasSlice )
+        {
+            m_data->currentSlice = slice;
+            m_data->hasSlice = true;
+        }
+        else if ( slice > m_data->currentSlice )
+        {
+            const qint64 numExpired =
+                qMin( slice - m_data->currentSlice, qint64( m_data->numSlices ) );
+
+            int slot = m_data->currentSlot.fetchAndAddAcquire( 0 );
+
+            for ( qint64 i = 0; i < numExpired; i++ )
+            {
+                /*
+                    The slot after the current one is the oldest one.
+                    It is cleared, before it becomes the current one.
+                 */
+                if ( ++slot == m_data->numSlices )
+                    slot = 0;
+
+                m_data->expireSlot( slot );
+                m_data->currentSlot.fetchAndStoreRelease( slot );
+            }
+
+            m_data->currentSlice = slice;
+        }
+    }
+
+    qint64 minCount = 0;
+    qint64 maxCount = 0;
+
+    for ( int i = 0; i < m_data->numBins; i++ )
+    {
+        const qint64 count =
+            qMax( qint64( m_data->totals[i].fetchAndAddAcquire( 0 ) ), qint64( 0 ) );
+        m_data->counts[i] = count;
+
+        if ( i == 0 || count < minCount )
+            minCount = count;
+
+        if ( i == 0 || count > maxCount )
+            maxCount = count;
+    }
+
+    const double min = m_data->interval.minValue();
+    const double max = m_data->interval.maxValue();
+
+    m_data->boundingRect.setRect( min, minCount, max - min, maxCount - minCount );
+
+    return m_data->appended.fetchAndStoreOrdered( 0 );
+}
+
+/*!
+   \brief Reset the counts of all bins
+
+   \note Values, that are appended from other threads while
+         clear() is running, might be counted or not.
+ */
+void QwtStreamingHistogramData::clear()
+{
+    if ( m_data->slices )
+    {
+        for ( int i = 0; i < m_data->numSlices * m_data->numBins; i++ )
+            m_data->slices[i].fetchAndStoreOrdered( 0 );
+    }
+
+    for ( int i = 0; i < m_data->numBins; i++ )
+        m_data->totals[i].fetchAndStoreOrdered( 0 );
+
+    m_data->appended.fetchAndStoreOrdered( 0 );
+
+    m_data->counts.fill( 0 );
+    m_data->boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+}
+
+/*!
+   \return Number of bins
+   \sa numBins()
+ */
+size_t QwtStreamingHistogramData::size() const
+{
+    return m_data->numBins;
+}
+
+/*!
+   \param index Index of the bin
+   \return Bin with the count of the last synchronization
+   \sa synchronize()
+ */
+QwtIntervalSample QwtStreamingHistogramData::sample( size_t index ) const
+{
+    const int i = static_cast< int >( index );
+
+    return QwtIntervalSample( m_data->counts[i],
+        m_data->binBorder( i ), m_data->binBorder( i + 1 ) );
+}
+
+/*!
+   \brief Bounding rectangle of the samples
+
+   The bounding rectangle is calculated in synchronize(), so
+   that boundingRect() is of O(1).
+
+   \return Bounding rectangle of the last synchronization
+ */
+QRectF QwtStreamingHistogramData::boundingRect() const
+{
+    return m_data->boundingRect;
+}
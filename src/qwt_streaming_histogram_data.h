@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_STREAMING_HISTOGRAM_DATA_H
+#define QWT_STREAMING_HISTOGRAM_DATA_H
+
+#include "qwt_global.h"
+#include "qwt_series_data.h"
+
+/*!
+   \brief A histogram, that is built from a stream of values
+
+   QwtStreamingHistogramData counts values into bins of fixed
+   or logarithmic width, so that a QwtPlotHistogram can display the
+   distribution of values, that are produced continuously -
+   f.e. by a QwtSamplingThread.
+
+   - append()\n
+     Values can be appended from any thread without locking. The
+     counters of the bins are 64 bit atomic integers ( 32 bit
+     for Qt < 5.3 ). Values outside of interval() are ignored.
+
+   - synchronize()\n
+     Has to be called from the GUI thread before replotting.
+     It takes over the counts of the bins, so that size(), sample()
+     and boundingRect() do not change while being painted.
+     The costs of synchronize() depend on the number of bins only.
+
+   With setTimeWindow() only the values of the most recent time
+   window are counted. The window is divided into slices and the
+   values are counted into the slice, that is current at the time of
+   appending. When synchronize() moves the window, the counts of the
+   expired slices are dropped. So the counts include the values of
+   the current slice and of the numSlices() - 1 slices before.
+
+   \par Example
+   \code
+ #include <qwt_streaming_histogram_data.h>
+ #include <qwt_plot_histogram.h>
+
+    QwtStreamingHistogramData* data =
+        new QwtStreamingHistogramData( QwtInterval( 0.0, 100.0 ), 50 );
+    data->setTimeWindow( 10.0, 20 ); // the last 10 seconds
+
+    QwtPlotHistogram* histogram = new QwtPlotHistogram();
+    histogram->setSamples( data );
+
+    // any thread
+    data->append( value );
+
+    // GUI thread, f.e. in a timer event
+    data->synchronize( elapsedTimer.elapsed() / 1000.0 );
+    plot->replot();
+   \endcode
+
+   \sa QwtPlotHistogram, QwtRingBufferSeriesData
+ */
+class QWT_EXPORT QwtStreamingHistogramData
+    : public QwtSeriesData< QwtIntervalSample >
+{
+  public:
+    //! Width of the bins
+    enum BinMode
+    {
+        //! All bins have the same width
+        LinearBins,
+
+        /*!
+           The bins have the same width on a logarithmic scale.
+           The interval has to be positive.
+         */
+        LogarithmicBins
+    };
+
+    QwtStreamingHistogramData( const QwtInterval&,
+        int numBins, BinMode = LinearBins );
+
+    virtual ~QwtStreamingHistogramData();
+
+    QwtInterval interval() const;
+    int numBins() const;
+    BinMode binMode() const;
+
+    void setTimeWindow( double length, int numSlices );
+    double timeWindow() const;
+    int numSlices() const;
+
+    void append( double value );
+    void append( const double* values, int numValues );
+
+    qint64 synchronize( double time = 0.0 );
+    void clear();
+
+    virtual size_t size() const QWT_OVERRIDE;
+    virtual QwtIntervalSample sample( size_t index ) const QWT_OVERRIDE;
+
+    virtual QRectF boundingRect() const QWT_OVERRIDE;
+
+  private:
+    Q_DISABLE_COPY( QwtStreamingHistogramData )
+
+    class PrivateData;
+    PrivateData* m_data;
+};
+
+#endif
@@ -22,6 +22,21 @@ QwtVectorFieldSymbol::~QwtVectorFieldSymbol()
 {
 }
 
+/*!
+    \brief Geometry of the symbol/arrow
+
+    The path is used to collect the symbols of the same color, so that
+    they can be painted at once ( QwtPlotVectorField::BatchSymbols ).
+    A symbol, that paints more than a path with the pen and brush of the painter,
+    has to return an empty path - what is the default implementation.
+
+    \return Path, that is painted by paint()
+ */
+QPainterPath QwtVectorFieldSymbol::path() const
+{
+    return QPainterPath();
+}
+
 class QwtVectorFieldArrow::PrivateData
 {
   public:
@@ -97,6 +112,11 @@ void QwtVectorFieldArrow::paint( QPainter* painter ) const
     painter->drawPath( m_data->path );
 }
 
+QPainterPath QwtVectorFieldArrow::path() const
+{
+    return m_data->path;
+}
+
 class QwtVectorFieldThinArrow::PrivateData
 {
   public:
@@ -158,3 +178,8 @@ void QwtVectorFieldThinArrow::paint(QPainter* p) const
 {
     p->drawPath( m_data->path );
 }
+
+QPainterPath QwtVectorFieldThinArrow::path() const
+{
+    return m_data->path;
+}
@@ -50,6 +50,8 @@ class QWT_EXPORT QwtVectorFieldSymbol
     //! Draw the symbol/arrow
     virtual void paint( QPainter* ) const = 0;
 
+    virtual QPainterPath path() const;
+
   private:
     Q_DISABLE_COPY(QwtVectorFieldSymbol)
 };
@@ -68,6 +70,7 @@ class QWT_EXPORT QwtVectorFieldArrow : public QwtVectorFieldSymbol
     virtual qreal length() const QWT_OVERRIDE;
 
     virtual void paint( QPainter* ) const QWT_OVERRIDE;
+    virtual QPainterPath path() const QWT_OVERRIDE;
 
   private:
     class PrivateData;
@@ -88,6 +91,7 @@ class QWT_EXPORT QwtVectorFieldThinArrow : public QwtVectorFieldSymbol
     virtual qreal length() const QWT_OVERRIDE;
 
     virtual void paint( QPainter* ) const QWT_OVERRIDE;
+    virtual QPainterPath path() const QWT_OVERRIDE;
 
   private:
     class PrivateData;
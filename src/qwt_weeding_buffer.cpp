@@ -0,0 +1,192 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_weeding_buffer.h"
+#include "qwt_weeding_curve_fitter.h"
+
+#include <qpolygon.h>
+
+class QwtWeedingBuffer::PrivateData
+{
+  public:
+    PrivateData()
+        : numPoints( 0 )
+        , numFinalPoints( 0 )
+        , isDirty( false )
+    {
+    }
+
+    void reset()
+    {
+        pendingPoints.clear();
+        fittedPoints.clear();
+
+        numPoints = 0;
+        numFinalPoints = 0;
+        isDirty = false;
+    }
+
+    // the chunks are handled here, the fitter simplifies one chunk only
+    QwtWeedingCurveFitter fitter;
+    uint chunkSize;
+
+    // points of the incomplete chunk
+    QPolygonF pendingPoints;
+
+    /*
+        the simplified points of the complete chunks followed by
+        the simplified points of the incomplete chunk
+     */
+    QPolygonF fittedPoints;
+
+    int numPoints;
+    int numFinalPoints;
+    bool isDirty;
+};
+
+/*!
+   Constructor
+
+   \param tolerance Tolerance
+   \param chunkSize Number of points of a chunk
+
+   \sa setTolerance(), setChunkSize()
+ */
+QwtWeedingBuffer::QwtWeedingBuffer( double tolerance, uint chunkSize )
+{
+    m_data = new PrivateData;
+    m_data->fitter.setTolerance( tolerance );
+
+    setChunkSize( chunkSize );
+}
+
+//! Destructor
+QwtWeedingBuffer::~QwtWeedingBuffer()
+{
+    delete m_data;
+}
+
+/*!
+   Assign the tolerance
+
+   \param tolerance Tolerance
+   \note All points are removed from the buffer
+   \sa tolerance(), QwtWeedingCurveFitter::setTolerance()
+ */
+void QwtWeedingBuffer::setTolerance( double tolerance )
+{
+    m_data->fitter.setTolerance( tolerance );
+    clear();
+}
+
+/*!
+   \return Tolerance
+   \sa setTolerance()
+ */
+double QwtWeedingBuffer::tolerance() const
+{
+    return m_data->fitter.tolerance();
+}
+
+/*!
+   Set the number of points of a chunk
+
+   Larger chunks give better results at the borders of the chunks, but
+   increase the costs of simplifying the incomplete chunk, when
+   polygon() is called after appending points.
+
+   \param chunkSize Number of points of a chunk, at least 3
+   \note All points are removed from the buffer
+   \sa chunkSize(), QwtWeedingCurveFitter::setChunkSize()
+ */
+void QwtWeedingBuffer::setChunkSize( uint chunkSize )
+{
+    m_data->chunkSize = qMax( chunkSize, 3U );
+    clear();
+}
+
+/*!
+   \return Number of points of a chunk
+   \sa setChunkSize()
+ */
+uint QwtWeedingBuffer::chunkSize() const
+{
+    return m_data->chunkSize;
+}
+
+/*!
+   Append a point
+
+   \param point Point
+   \sa polygon()
+ */
+void QwtWeedingBuffer::append( const QPointF& point )
+{
+    m_data->pendingPoints += point;
+    m_data->numPoints++;
+    m_data->isDirty = true;
+
+    if ( m_data->pendingPoints.size() == static_cast< int >( m_data->chunkSize ) )
+    {
+        // the chunk is complete and will never change again
+
+        m_data->fittedPoints.resize( m_data->numFinalPoints );
+        m_data->fittedPoints += m_data->fitter.fitCurve( m_data->pendingPoints );
+
+        m_data->numFinalPoints = m_data->fittedPoints.size();
+
+        m_data->pendingPoints.clear();
+        m_data->isDirty = false;
+    }
+}
+
+/*!
+   Append points
+
+   \param points Points
+   \sa polygon()
+ */
+void QwtWeedingBuffer::append( const QPolygonF& points )
+{
+    for ( int i = 0; i < points.size(); i++ )
+        append( points[i] );
+}
+
+//! Remove all points
+void QwtWeedingBuffer::clear()
+{
+    m_data->reset();
+}
+
+//! \return Number of points, that have been appended
+int QwtWeedingBuffer::numPoints() const
+{
+    return m_data->numPoints;
+}
+
+/*!
+   \return Simplified polygon of all points, that have been appended
+
+   Only the points of the incomplete chunk are simplified, when
+   points have been appended since the previous call.
+ */
+QPolygonF QwtWeedingBuffer::polygon() const
+{
+    if ( m_data->isDirty )
+    {
+        m_data->fittedPoints.resize( m_data->numFinalPoints );
+
+        if ( !m_data->pendingPoints.isEmpty() )
+            m_data->fittedPoints += m_data->fitter.fitCurve( m_data->pendingPoints );
+
+        m_data->isDirty = false;
+    }
+
+    return m_data->fittedPoints;
+}
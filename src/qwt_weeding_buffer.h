@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_WEEDING_BUFFER_H
+#define QWT_WEEDING_BUFFER_H
+
+#include "qwt_global.h"
+
+class QPointF;
+class QPolygonF;
+
+/*!
+   \brief Incremental Douglas and Peucker simplification of a growing polygon
+
+   QwtWeedingBuffer simplifies a polygon, that is built by appending
+   points - f.e. the samples of a live telemetry curve - without running
+   the algorithm for the complete history each time.
+
+   The points are split into chunks of chunkSize() points like in
+   QwtWeedingCurveFitter. Once a chunk is complete it is simplified
+   and never touched again. So the costs of updating polygon() depend
+   on the chunk size and the number of appended points only.
+
+   The simplified polygon is the same as the result of
+   QwtWeedingCurveFitter::fitCurve() for all appended points,
+   when using the same tolerance and chunk size.
+
+   \par Example
+   \code
+ #include <qwt_weeding_buffer.h>
+
+    QwtWeedingBuffer buffer( 0.01, 500 );
+
+    // for each new sample
+    buffer.append( QPointF( time, value ) );
+
+    // for each frame
+    curve->setSamples( buffer.polygon() );
+   \endcode
+
+   \note As the tolerance is in the coordinates of the appended points,
+         the points have to be in a coordinate system, where the tolerance
+         has a fixed meaning - f.e. scale coordinates with a fixed range.
+
+   \sa QwtWeedingCurveFitter
+ */
+class QWT_EXPORT QwtWeedingBuffer
+{
+  public:
+    explicit QwtWeedingBuffer( double tolerance = 1.0, uint chunkSize = 1000 );
+    ~QwtWeedingBuffer();
+
+    void setTolerance( double );
+    double tolerance() const;
+
+    void setChunkSize( uint );
+    uint chunkSize() const;
+
+    void append( const QPointF& );
+    void append( const QPolygonF& );
+
+    void clear();
+
+    int numPoints() const;
+    QPolygonF polygon() const;
+
+  private:
+    Q_DISABLE_COPY( QwtWeedingBuffer )
+
+    class PrivateData;
+    PrivateData* m_data;
+};
+
+#endif
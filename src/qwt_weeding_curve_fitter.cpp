@@ -15,17 +15,27 @@
 #include <qstack.h>
 #include <qvector.h>
 
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+#if !defined( QT_NO_QFUTURE )
+#define QWT_USE_THREADS 1
+#endif
+
 class QwtWeedingCurveFitter::PrivateData
 {
   public:
     PrivateData()
         : tolerance( 1.0 )
         , chunkSize( 0 )
+        , numThreads( 1 )
     {
     }
 
     double tolerance;
     uint chunkSize;
+    uint numThreads;
 };
 
 class QwtWeedingCurveFitter::Line
@@ -116,6 +126,32 @@ uint QwtWeedingCurveFitter::chunkSize() const
     return m_data->chunkSize;
 }
 
+/*!
+   Set the number of threads for simplifying the chunks of a polygon
+
+   The chunks are distributed to the threads, so that
+   this setting has no effect, when the chunk size is 0.
+
+   \param numThreads Number of threads. When numThreads is set to 0 the
+                     system specific ideal thread count is used.
+                     The default thread count is 1 ( = no additional threads )
+
+   \sa threadCount(), setChunkSize()
+ */
+void QwtWeedingCurveFitter::setThreadCount( uint numThreads )
+{
+    m_data->numThreads = numThreads;
+}
+
+/*!
+   \return Number of threads for simplifying the chunks of a polygon
+   \sa setThreadCount()
+ */
+uint QwtWeedingCurveFitter::threadCount() const
+{
+    return m_data->numThreads;
+}
+
 /*!
    \param points Series of data points
    \return Curve points
@@ -126,18 +162,71 @@ QPolygonF QwtWeedingCurveFitter::fitCurve( const QPolygonF& points ) const
     if ( points.isEmpty() )
         return points;
 
-    QPolygonF fittedPoints;
     if ( m_data->chunkSize == 0 )
+        return simplify( points );
+
+    const int chunkSize = static_cast< int >( m_data->chunkSize );
+    const int numChunks = ( points.size() + chunkSize - 1 ) / chunkSize;
+
+#if QWT_USE_THREADS
+    int numThreads = static_cast< int >( m_data->numThreads );
+    if ( numThreads == 0 )
+        numThreads = QThread::idealThreadCount();
+
+    numThreads = qMin( numThreads, numChunks );
+
+    if ( numThreads > 1 )
     {
-        fittedPoints = simplify( points );
-    }
-    else
-    {
-        for ( int i = 0; i < points.size(); i += m_data->chunkSize )
+        // each thread simplifies a range of complete chunks
+
+        const int chunksPerThread = numChunks / numThreads;
+
+        QVector< QFuture< QPolygonF > > futures;
+        futures.reserve( numThreads - 1 );
+
+        int from = 0;
+        for ( int i = 0; i < numThreads - 1; i++ )
         {
-            const QPolygonF p = points.mid( i, m_data->chunkSize );
-            fittedPoints += simplify( p );
+            const int to = from + chunksPerThread * chunkSize;
+
+            futures += QtConcurrent::run(
+#if QT_VERSION >= 0x060000
+                &QwtWeedingCurveFitter::simplifyChunks, this,
+#else
+                this, &QwtWeedingCurveFitter::simplifyChunks,
+#endif
+                points, from, to );
+
+            from = to;
         }
+
+        const QPolygonF lastPoints = simplifyChunks( points, from, points.size() );
+
+        QPolygonF fittedPoints;
+        for ( int i = 0; i < futures.size(); i++ )
+            fittedPoints += futures[i].result();
+
+        fittedPoints += lastPoints;
+
+        return fittedPoints;
+    }
+#else
+    Q_UNUSED( numChunks );
+#endif
+
+    return simplifyChunks( points, 0, points.size() );
+}
+
+QPolygonF QwtWeedingCurveFitter::simplifyChunks(
+    const QPolygonF& points, int from, int to ) const
+{
+    const int chunkSize = static_cast< int >( m_data->chunkSize );
+
+    QPolygonF fittedPoints;
+    for ( int i = from; i < to; i += chunkSize )
+    {
+        const QPolygonF p = points.mid( i, qMin( chunkSize, to - i ) );
+        fittedPoints += simplify( p );
     }
 
     return fittedPoints;
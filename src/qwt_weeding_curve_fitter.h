@@ -25,7 +25,9 @@
    and might be very slow for huge polygons. To avoid performance issues
    it might be useful to split the polygon ( setChunkSize() ) and to run the algorithm
    for these smaller parts. The disadvantage of having no interpolation
-   at the borders is for most use cases irrelevant.
+   at the borders is for most use cases irrelevant. As the chunks are
+   independent from each other they can be processed in parallel
+   ( setThreadCount() ).
 
    The smoothed curve consists of a subset of the points that defined the
    original curve.
@@ -34,6 +36,8 @@
    the number of points. By adjusting the tolerance parameter according to the
    axis scales QwtSplineCurveFitter can be used to implement different
    level of details to speed up painting of curves of many points.
+
+   \sa QwtWeedingBuffer
  */
 class QWT_EXPORT QwtWeedingCurveFitter : public QwtCurveFitter
 {
@@ -47,11 +51,15 @@ class QWT_EXPORT QwtWeedingCurveFitter : public QwtCurveFitter
     void setChunkSize( uint );
     uint chunkSize() const;
 
+    void setThreadCount( uint numThreads );
+    uint threadCount() const;
+
     virtual QPolygonF fitCurve( const QPolygonF& ) const QWT_OVERRIDE;
     virtual QPainterPath fitCurvePath( const QPolygonF& ) const QWT_OVERRIDE;
 
   private:
     virtual QPolygonF simplify( const QPolygonF& ) const;
+    QPolygonF simplifyChunks( const QPolygonF&, int from, int to ) const;
 
     class Line;
 
@@ -109,6 +109,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_curve_fitter.h \
         qwt_spline_curve_fitter.h \
         qwt_weeding_curve_fitter.h \
+        qwt_weeding_buffer.h \
         qwt_event_pattern.h \
         qwt_abstract_legend.h \
         qwt_legend.h \
@@ -148,6 +149,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_plot_magnifier.h \
         qwt_plot_rescaler.h \
         qwt_point_mapper.h \
+        qwt_point_index.h \
         qwt_raster_data.h \
         qwt_matrix_raster_data.h \
         qwt_vectorfield_symbol.h \
@@ -156,12 +158,16 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_series_data.h \
         qwt_series_store.h \
         qwt_point_data.h \
+        qwt_pyramid_point_data.h \
+        qwt_ring_buffer_series_data.h \
+        qwt_streaming_histogram_data.h \
         qwt_scale_widget.h 
 
     SOURCES += \
         qwt_curve_fitter.cpp \
         qwt_spline_curve_fitter.cpp \
         qwt_weeding_curve_fitter.cpp \
+        qwt_weeding_buffer.cpp \
         qwt_abstract_legend.cpp \
         qwt_legend.cpp \
         qwt_legend_data.cpp \
@@ -201,12 +207,16 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_plot_magnifier.cpp \
         qwt_plot_rescaler.cpp \
         qwt_point_mapper.cpp \
+        qwt_point_index.cpp \
         qwt_raster_data.cpp \
         qwt_matrix_raster_data.cpp \
         qwt_vectorfield_symbol.cpp \
         qwt_sampling_thread.cpp \
         qwt_series_data.cpp \
         qwt_point_data.cpp \
+        qwt_pyramid_point_data.cpp \
+        qwt_ring_buffer_series_data.cpp \
+        qwt_streaming_histogram_data.cpp \
         qwt_scale_widget.cpp
 
     contains(QWT_CONFIG, QwtOpenGL) {
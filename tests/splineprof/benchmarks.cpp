@@ -0,0 +1,400 @@
+/*****************************************************************************
+* Qwt Examples - Copyright (C) 2002 Uwe Rathmann
+* This file may be used under the terms of the 3-clause BSD License
+*****************************************************************************/
+
+#include "benchmarks.h"
+
+#include <QwtSplinePleasing>
+#include <QwtSplineLocal>
+#include <QwtSplineCubic>
+#include <QwtSplineParametrization>
+#include <QwtPointMapper>
+#include <QwtPointSeriesData>
+#include <QwtClipper>
+#include <QwtWeedingCurveFitter>
+#include <QwtPlotSpectrogram>
+#include <QwtMatrixRasterData>
+#include <QwtLinearColorMap>
+#include <QwtScaleMap>
+#include <QwtInterval>
+
+#include <QPolygon>
+#include <QLine>
+#include <QImage>
+#include <QPen>
+
+#include <cmath>
+
+Benchmark::Benchmark( const QString& name )
+    : m_name( name )
+{
+}
+
+Benchmark::~Benchmark()
+{
+}
+
+QString Benchmark::name() const
+{
+    return m_name;
+}
+
+void Benchmark::init( const Settings& )
+{
+}
+
+static QPolygonF samplePoints( int numPoints )
+{
+    QPolygonF points( numPoints );
+
+    for ( int i = 0; i < numPoints; i++ )
+        points[i] = QPointF( i, std::sin( double( i ) ) );
+
+    return points;
+}
+
+namespace
+{
+    class SplineBenchmark : public Benchmark
+    {
+      public:
+        SplineBenchmark( const QString& name,
+                QwtSplineInterpolating* spline, int paramType )
+            : Benchmark( name )
+            , m_spline( spline )
+        {
+            m_spline->setParametrization( paramType );
+        }
+
+        virtual ~SplineBenchmark()
+        {
+            delete m_spline;
+        }
+
+        virtual void init( const Settings& settings ) QWT_OVERRIDE
+        {
+            m_points = samplePoints( settings.numPoints );
+        }
+
+        virtual int run() QWT_OVERRIDE
+        {
+            const QVector< QLineF > lines = m_spline->bezierControlLines( m_points );
+            return m_points.size();
+        }
+
+      private:
+        QwtSplineInterpolating* m_spline;
+        QPolygonF m_points;
+    };
+
+    class PaintBenchmark : public Benchmark
+    {
+      public:
+        explicit PaintBenchmark( const QString& name )
+            : Benchmark( name )
+        {
+        }
+
+        virtual void init( const Settings& settings ) QWT_OVERRIDE
+        {
+            m_imageSize = settings.imageSize;
+            m_numThreads = settings.numThreads;
+
+            m_points = samplePoints( settings.numPoints );
+
+            m_xMap.setPaintInterval( 0, m_imageSize.width() - 1 );
+            m_xMap.setScaleInterval( 0.0, settings.numPoints - 1 );
+
+            m_yMap.setPaintInterval( m_imageSize.height() - 1, 0 );
+            m_yMap.setScaleInterval( -1.0, 1.0 );
+        }
+
+      protected:
+        QSize m_imageSize;
+        uint m_numThreads;
+
+        QPolygonF m_points;
+
+        QwtScaleMap m_xMap;
+        QwtScaleMap m_yMap;
+    };
+
+    class MapperBenchmark : public PaintBenchmark
+    {
+      public:
+        enum Mode
+        {
+            Polyline,
+            PolylineFiltered,
+            PolylineAggressive,
+            Image
+        };
+
+        MapperBenchmark( const QString& name, Mode mode )
+            : PaintBenchmark( name )
+            , m_mode( mode )
+        {
+        }
+
+        virtual void init( const Settings& settings ) QWT_OVERRIDE
+        {
+            PaintBenchmark::init( settings );
+
+            m_mapper.setBoundingRect( QRectF( QPointF( 0.0, 0.0 ), m_imageSize ) );
+
+            m_mapper.setFlag( QwtPointMapper::WeedOutPoints,
+                m_mode == PolylineFiltered || m_mode == PolylineAggressive );
+
+            m_mapper.setFlag( QwtPointMapper::RoundPoints,
+                m_mode == PolylineAggressive );
+
+            m_mapper.setFlag( QwtPointMapper::WeedOutIntermediatePoints,
+                m_mode == PolylineAggressive );
+        }
+
+        virtual int run() QWT_OVERRIDE
+        {
+            QwtPointSeriesData series( m_points );
+            const int to = m_points.size() - 1;
+
+            if ( m_mode == Image )
+            {
+                const QImage image = m_mapper.toImage( m_xMap, m_yMap,
+                    &series, 0, to, QPen( Qt::black ), false, m_numThreads );
+            }
+            else
+            {
+                const QPolygonF polyline = m_mapper.toPolygonF(
+                    m_xMap, m_yMap, &series, 0, to, m_numThreads );
+            }
+
+            return m_points.size();
+        }
+
+      private:
+        const Mode m_mode;
+        QwtPointMapper m_mapper;
+    };
+
+    class ClipperBenchmark : public PaintBenchmark
+    {
+      public:
+        ClipperBenchmark()
+            : PaintBenchmark( "Clipper" )
+        {
+        }
+
+        virtual void init( const Settings& settings ) QWT_OVERRIDE
+        {
+            PaintBenchmark::init( settings );
+
+            m_polygon.resize( m_points.size() );
+            for ( int i = 0; i < m_points.size(); i++ )
+            {
+                m_polygon[i].rx() = m_xMap.transform( m_points[i].x() );
+                m_polygon[i].ry() = m_yMap.transform( m_points[i].y() );
+            }
+
+            // clipping the upper part of the curve
+            m_clipRect = QRectF( 0.0, 0.25 * m_imageSize.height(),
+                m_imageSize.width(), 0.75 * m_imageSize.height() );
+        }
+
+        virtual int run() QWT_OVERRIDE
+        {
+            const QPolygonF polygon =
+                QwtClipper::clippedPolygonF( m_clipRect, m_polygon );
+
+            return m_polygon.size();
+        }
+
+      private:
+        QPolygonF m_polygon;
+        QRectF m_clipRect;
+    };
+
+    class WeedingBenchmark : public PaintBenchmark
+    {
+      public:
+        WeedingBenchmark( const QString& name, uint chunkSize )
+            : PaintBenchmark( name )
+        {
+            m_fitter.setTolerance( 1.0 );
+            m_fitter.setChunkSize( chunkSize );
+        }
+
+        virtual void init( const Settings& settings ) QWT_OVERRIDE
+        {
+            PaintBenchmark::init( settings );
+
+            m_polygon.resize( m_points.size() );
+            for ( int i = 0; i < m_points.size(); i++ )
+            {
+                m_polygon[i].rx() = m_xMap.transform( m_points[i].x() );
+                m_polygon[i].ry() = m_yMap.transform( m_points[i].y() );
+            }
+        }
+
+        virtual int run() QWT_OVERRIDE
+        {
+            const QPolygonF polygon = m_fitter.fitCurve( m_polygon );
+            return m_polygon.size();
+        }
+
+      private:
+        QwtWeedingCurveFitter m_fitter;
+        QPolygonF m_polygon;
+    };
+
+    class Spectrogram : public QwtPlotSpectrogram
+    {
+      public:
+        QImage render( const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+            const QRectF& area, const QSize& imageSize ) const
+        {
+            return renderImage( xMap, yMap, area, imageSize );
+        }
+    };
+
+    class SpectrogramBenchmark : public Benchmark
+    {
+      public:
+        SpectrogramBenchmark( const QString& name,
+                QwtMatrixRasterData::ResampleMode resampleMode )
+            : Benchmark( name )
+            , m_resampleMode( resampleMode )
+        {
+        }
+
+        virtual void init( const Settings& settings ) QWT_OVERRIDE
+        {
+            const int numColumns = 500;
+            const int numRows = 500;
+
+            QVector< double > values( numColumns * numRows );
+            for ( int row = 0; row < numRows; row++ )
+            {
+                for ( int col = 0; col < numColumns; col++ )
+                {
+                    values[ row * numColumns + col ] =
+                        std::sin( 0.05 * col ) * std::cos( 0.03 * row );
+                }
+            }
+
+            QwtMatrixRasterData* data = new QwtMatrixRasterData();
+            data->setInterval( Qt::XAxis, QwtInterval( 0.0, numColumns ) );
+            data->setInterval( Qt::YAxis, QwtInterval( 0.0, numRows ) );
+            data->setInterval( Qt::ZAxis, QwtInterval( -1.0, 1.0 ) );
+            data->setValueMatrix( values, numColumns );
+            data->setResampleMode( m_resampleMode );
+
+            m_spectrogram.setData( data );
+            m_spectrogram.setColorMap( new QwtLinearColorMap( Qt::darkCyan, Qt::red ) );
+            m_spectrogram.setRenderThreadCount( settings.numThreads );
+
+            m_imageSize = settings.imageSize;
+            m_area = QRectF( 0.0, 0.0, numColumns, numRows );
+
+            m_xMap.setPaintInterval( 0, m_imageSize.width() );
+            m_xMap.setScaleInterval( 0.0, numColumns );
+
+            m_yMap.setPaintInterval( m_imageSize.height(), 0 );
+            m_yMap.setScaleInterval( 0.0, numRows );
+        }
+
+        virtual int run() QWT_OVERRIDE
+        {
+            const QImage image = m_spectrogram.render(
+                m_xMap, m_yMap, m_area, m_imageSize );
+
+            return m_imageSize.width() * m_imageSize.height();
+        }
+
+      private:
+        const QwtMatrixRasterData::ResampleMode m_resampleMode;
+
+        Spectrogram m_spectrogram;
+
+        QSize m_imageSize;
+        QRectF m_area;
+
+        QwtScaleMap m_xMap;
+        QwtScaleMap m_yMap;
+    };
+}
+
+static void addSplineBenchmarks( QList< Benchmark* >& benchmarks,
+    const QString& paramName, int paramType )
+{
+    const QString prefix = QString( "Spline/%1/" ).arg( paramName );
+
+    benchmarks += new SplineBenchmark( prefix + "Cardinal",
+        new QwtSplineLocal( QwtSplineLocal::Cardinal ), paramType );
+
+    benchmarks += new SplineBenchmark( prefix + "PChip",
+        new QwtSplineLocal( QwtSplineLocal::PChip ), paramType );
+
+    benchmarks += new SplineBenchmark( prefix + "Akima",
+        new QwtSplineLocal( QwtSplineLocal::Akima ), paramType );
+
+    benchmarks += new SplineBenchmark( prefix + "ParabolicBlending",
+        new QwtSplineLocal( QwtSplineLocal::ParabolicBlending ), paramType );
+
+    benchmarks += new SplineBenchmark( prefix + "Cubic",
+        new QwtSplineCubic(), paramType );
+
+    benchmarks += new SplineBenchmark( prefix + "Pleasing",
+        new QwtSplinePleasing(), paramType );
+}
+
+QList< Benchmark* > createBenchmarks()
+{
+    QList< Benchmark* > benchmarks;
+
+    addSplineBenchmarks( benchmarks, "X",
+        QwtSplineParametrization::ParameterX );
+
+    addSplineBenchmarks( benchmarks, "Y",
+        QwtSplineParametrization::ParameterY );
+
+    addSplineBenchmarks( benchmarks, "Uniform",
+        QwtSplineParametrization::ParameterUniform );
+
+    addSplineBenchmarks( benchmarks, "Manhattan",
+        QwtSplineParametrization::ParameterManhattan );
+
+    addSplineBenchmarks( benchmarks, "Chordal",
+        QwtSplineParametrization::ParameterChordal );
+
+    addSplineBenchmarks( benchmarks, "Centripetal",
+        QwtSplineParametrization::ParameterCentripetal );
+
+    benchmarks += new MapperBenchmark(
+        "PointMapper/Polyline", MapperBenchmark::Polyline );
+
+    benchmarks += new MapperBenchmark(
+        "PointMapper/PolylineFiltered", MapperBenchmark::PolylineFiltered );
+
+    benchmarks += new MapperBenchmark(
+        "PointMapper/PolylineAggressive", MapperBenchmark::PolylineAggressive );
+
+    benchmarks += new MapperBenchmark(
+        "PointMapper/Image", MapperBenchmark::Image );
+
+    benchmarks += new ClipperBenchmark();
+
+    benchmarks += new WeedingBenchmark( "WeedingCurveFitter", 0 );
+    benchmarks += new WeedingBenchmark( "WeedingCurveFitter/Chunks", 1000 );
+
+    benchmarks += new SpectrogramBenchmark(
+        "Spectrogram/NearestNeighbour", QwtMatrixRasterData::NearestNeighbour );
+
+    benchmarks += new SpectrogramBenchmark(
+        "Spectrogram/BilinearInterpolation", QwtMatrixRasterData::BilinearInterpolation );
+
+    benchmarks += new SpectrogramBenchmark(
+        "Spectrogram/BicubicInterpolation", QwtMatrixRasterData::BicubicInterpolation );
+
+    return benchmarks;
+}
@@ -0,0 +1,45 @@
+/*****************************************************************************
+* Qwt Examples - Copyright (C) 2002 Uwe Rathmann
+* This file may be used under the terms of the 3-clause BSD License
+*****************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QSize>
+#include <QList>
+
+class Settings
+{
+  public:
+    Settings()
+        : numPoints( 1000000 )
+        , imageSize( 800, 600 )
+        , numThreads( 1 )
+    {
+    }
+
+    int numPoints;
+    QSize imageSize;
+    uint numThreads;
+};
+
+class Benchmark
+{
+  public:
+    explicit Benchmark( const QString& name );
+    virtual ~Benchmark();
+
+    QString name() const;
+
+    // creating the input, not included in the measurement
+    virtual void init( const Settings& );
+
+    // returns the number of points, that have been processed
+    virtual int run() = 0;
+
+  private:
+    const QString m_name;
+};
+
+QList< Benchmark* > createBenchmarks();
@@ -3,99 +3,364 @@
 * This file may be used under the terms of the 3-clause BSD License
 *****************************************************************************/
 
-#include <QwtSplinePleasing>
-#include <QwtSplineLocal>
-#include <QwtSplineCubic>
-#include <QwtSplineParametrization>
+#include "benchmarks.h"
 
+#include <QwtGlobal>
+
+#include <QApplication>
 #include <QElapsedTimer>
+#include <QStringList>
+
+#include <cstdio>
 
-#include <QPolygon>
-#include <QLine>
-#include <QDebug>
+#if defined( Q_OS_WIN )
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined( Q_OS_UNIX )
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 
-static void testSpline( const char* name, QwtSplineInterpolating* spline,
-    int type, const QPolygonF& points )
+namespace
 {
-    spline->setParametrization( type );
+    class Result
+    {
+      public:
+        QString name;
+        int numPoints;
+        int iterations;
+        qint64 nsecs; // fastest iteration
+        qint64 retainedMemory; // growth in KiB, -1 if unknown
+        qint64 peakMemory; // in KiB, -1 if unknown
+        bool isBenchmarkPeak; // false: peak of the process so far
+    };
+}
 
-    QElapsedTimer timer;
-    timer.start();
+// current resident memory of the process in KiB
+static qint64 residentMemory()
+{
+#if defined( Q_OS_WIN )
+    PROCESS_MEMORY_COUNTERS counters;
+    if ( GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+        return counters.WorkingSetSize / 1024;
+#elif defined( Q_OS_LINUX )
+    long pages = -1;
 
-    const QVector< QLineF > lines = spline->bezierControlLines( points );
+    if ( FILE* file = fopen( "/proc/self/statm", "r" ) )
+    {
+        long size;
+        if ( fscanf( file, "%ld %ld", &size, &pages ) != 2 )
+            pages = -1;
 
-    qDebug() << name << ":" << timer.elapsed();
+        fclose( file );
+    }
+
+    if ( pages >= 0 )
+        return qint64( pages ) * sysconf( _SC_PAGESIZE ) / 1024;
+#endif
+
+    return -1;
 }
 
-static void testSplines( int paramType, const QPolygonF& points )
+/*
+    Reset the high-water mark of the resident memory to the current
+    resident memory, so that peakMemory() is the peak of the following
+    benchmark. Only possible on Linux ( >= 4.0 ).
+ */
+static bool resetPeakMemory()
 {
-#if 0
-    QwtSplinePleasing splinePleasing;
-    testSpline( "Pleasing", &splinePleasing, paramType, points );
+#if defined( Q_OS_LINUX )
+    if ( FILE* file = fopen( "/proc/self/clear_refs", "w" ) )
+    {
+        const bool ok = ( fputs( "5", file ) >= 0 );
+        return ( fclose( file ) == 0 ) && ok;
+    }
 #endif
 
-#if 1
-    QwtSplineLocal splineCardinal( QwtSplineLocal::Cardinal );
-    testSpline( "Cardinal", &splineCardinal, paramType, points );
-#endif
+    return false;
+}
 
-#if 1
-    QwtSplineLocal splinePC( QwtSplineLocal::PChip );
-    testSpline( "PChip", &splinePC, paramType, points );
-#endif
+/*
+    High-water mark of the resident memory of the process in KiB.
+    Unless it has been reset by resetPeakMemory() it is the peak
+    of all benchmarks, that have been run so far.
+ */
+static qint64 peakMemory()
+{
+#if defined( Q_OS_WIN )
+    PROCESS_MEMORY_COUNTERS counters;
+    if ( GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+        return counters.PeakWorkingSetSize / 1024;
+#elif defined( Q_OS_UNIX )
+#if defined( Q_OS_LINUX )
+    // unlike ru_maxrss VmHWM is affected by resetPeakMemory()
+    if ( FILE* file = fopen( "/proc/self/status", "r" ) )
+    {
+        qint64 peak = -1;
 
-#if 1
-    QwtSplineLocal splineAkima( QwtSplineLocal::Akima );
-    testSpline( "Akima", &splineAkima, paramType, points );
-#endif
+        char line[256];
+        while ( fgets( line, sizeof( line ), file ) )
+        {
+            long long kib;
+            if ( sscanf( line, "VmHWM: %lld kB", &kib ) == 1 )
+            {
+                peak = kib;
+                break;
+            }
+        }
+
+        fclose( file );
 
-#if 1
-    QwtSplineLocal splinePB( QwtSplineLocal::ParabolicBlending );
-    testSpline( "Parabolic Blending", &splinePB, paramType, points );
+        if ( peak >= 0 )
+            return peak;
+    }
 #endif
 
-#if 1
-    QwtSplineCubic splineC2;
-    testSpline( "Cubic", &splineC2, paramType, points );
+    struct rusage usage;
+    if ( getrusage( RUSAGE_SELF, &usage ) == 0 )
+    {
+#if defined( Q_OS_MAC )
+        return usage.ru_maxrss / 1024; // bytes
+#else
+        return usage.ru_maxrss;
 #endif
+    }
+#endif
+
+    return -1;
 }
 
-int main( int, char*[] )
+static Result runBenchmark( Benchmark* benchmark,
+    const Settings& settings, int iterations )
 {
-    QPolygonF points;
+    const qint64 residentBefore = residentMemory();
 
-    for ( int i = 0; i < 10e6; i++ )
-        points += QPointF( i, std::sin( i ) );
+    Result result;
+    result.isBenchmarkPeak = resetPeakMemory();
 
-#if 1
-    qDebug() << "=== X";
-    testSplines( QwtSplineParametrization::ParameterX, points );
-#endif
+    benchmark->init( settings );
 
-#if 1
-    qDebug() << "=== Y";
-    testSplines( QwtSplineParametrization::ParameterY, points );
-#endif
+    result.name = benchmark->name();
+    result.numPoints = 0;
+    result.iterations = iterations;
+    result.nsecs = -1;
 
-#if 1
-    qDebug() << "=== Uniform";
-    testSplines( QwtSplineParametrization::ParameterUniform, points );
-#endif
+    for ( int i = 0; i < iterations; i++ )
+    {
+        QElapsedTimer timer;
+        timer.start();
 
-#if 1
-    qDebug() << "=== Manhattan";
-    testSplines( QwtSplineParametrization::ParameterManhattan, points );
-#endif
+        result.numPoints = benchmark->run();
 
-#if 1
-    qDebug() << "=== Chordal";
-    testSplines( QwtSplineParametrization::ParameterChordal, points );
-#endif
+        const qint64 nsecs = timer.nsecsElapsed();
+        if ( result.nsecs < 0 || nsecs < result.nsecs )
+            result.nsecs = nsecs;
+    }
+
+    // the benchmark still holds its data, the results have been released
+    const qint64 residentAfter = residentMemory();
+
+    result.retainedMemory = -1;
+    if ( residentBefore >= 0 && residentAfter >= 0 )
+        result.retainedMemory = residentAfter - residentBefore;
 
-#if 1
-    qDebug() << "=== Centripetral";
-    testSplines( QwtSplineParametrization::ParameterCentripetal, points );
+    result.peakMemory = peakMemory();
+
+    return result;
+}
+
+static const char* peakScope( const Result& result )
+{
+    return result.isBenchmarkPeak ? "benchmark" : "process";
+}
+
+static double nsecsPerPoint( const Result& result )
+{
+    if ( result.numPoints <= 0 )
+        return 0.0;
+
+    return double( result.nsecs ) / result.numPoints;
+}
+
+static void printCsvHeader()
+{
+    printf( "benchmark,points,iterations,ns,ns_per_point,"
+        "retained_kib,peak_kib,peak_scope\n" );
+}
+
+static void printCsvRow( const Result& r )
+{
+    printf( "%s,%d,%d,%lld,%.3f,%lld,%lld,%s\n", qPrintable( r.name ),
+        r.numPoints, r.iterations, static_cast< long long >( r.nsecs ),
+        nsecsPerPoint( r ), static_cast< long long >( r.retainedMemory ),
+        static_cast< long long >( r.peakMemory ), peakScope( r ) );
+
+    // the rows are printed immediately to see the progress
+    fflush( stdout );
+}
+
+static void printJson( const Settings& settings, const QList< Result >& results )
+{
+    printf( "{\n" );
+    printf( "  \"qwt\": \"%s\",\n", QWT_VERSION_STR );
+    printf( "  \"qt\": \"%s\",\n", qVersion() );
+    printf( "  \"points\": %d,\n", settings.numPoints );
+    printf( "  \"image\": [ %d, %d ],\n",
+        settings.imageSize.width(), settings.imageSize.height() );
+    printf( "  \"threads\": %u,\n", settings.numThreads );
+    printf( "  \"results\": [\n" );
+
+    for ( int i = 0; i < results.size(); i++ )
+    {
+        const Result& r = results[i];
+
+        printf( "    { \"benchmark\": \"%s\", \"points\": %d, \"iterations\": %d, "
+            "\"ns\": %lld, \"ns_per_point\": %.3f, \"retained_kib\": %lld, "
+            "\"peak_kib\": %lld, \"peak_scope\": \"%s\" }%s\n",
+            qPrintable( r.name ), r.numPoints, r.iterations,
+            static_cast< long long >( r.nsecs ), nsecsPerPoint( r ),
+            static_cast< long long >( r.retainedMemory ),
+            static_cast< long long >( r.peakMemory ), peakScope( r ),
+            ( i < results.size() - 1 ) ? "," : "" );
+    }
+
+    printf( "  ]\n" );
+    printf( "}\n" );
+}
+
+static void printUsage()
+{
+    fprintf( stderr,
+        "Usage: splineprof [options]\n"
+        "  --format csv|json   Output format ( default: csv )\n"
+        "  --points N          Number of points ( default: 1000000 )\n"
+        "  --image WxH         Size of the image ( default: 800x600 )\n"
+        "  --iterations N      Iterations of each benchmark, the fastest\n"
+        "                      one is reported ( default: 3 )\n"
+        "  --threads N         Threads for the item renderers, 0 for\n"
+        "                      the ideal thread count ( default: 1 )\n"
+        "  --filter TEXT       Run benchmarks containing TEXT only\n"
+        "  --list              List the benchmarks\n"
+        "\n"
+        "retained_kib is the growth of the resident memory, that is\n"
+        "retained after a benchmark. peak_kib is the peak of the resident\n"
+        "memory while running the benchmark, when peak_scope is \"benchmark\"\n"
+        "( Linux ). Otherwise it is the peak of the process for all benchmarks\n"
+        "so far - use --filter to get the peak of a single benchmark.\n" );
+}
+
+int main( int argc, char* argv[] )
+{
+#if QT_VERSION >= 0x050000
+    // no display needed
+    if ( qgetenv( "QT_QPA_PLATFORM" ).isEmpty() )
+        qputenv( "QT_QPA_PLATFORM", "offscreen" );
 #endif
 
+    QApplication app( argc, argv );
+
+    Settings settings;
+    QString format = "csv";
+    QString filter;
+    int iterations = 3;
+    bool listOnly = false;
+
+    const QStringList args = app.arguments();
+    for ( int i = 1; i < args.size(); i++ )
+    {
+        const QString& arg = args[i];
+        const QString value = ( i + 1 < args.size() ) ? args[i + 1] : QString();
+
+        bool ok = true;
+
+        if ( arg == "--list" )
+        {
+            listOnly = true;
+            continue;
+        }
+
+        if ( arg == "--format" && ( value == "csv" || value == "json" ) )
+        {
+            format = value;
+        }
+        else if ( arg == "--points" )
+        {
+            settings.numPoints = value.toInt( &ok );
+            ok = ok && settings.numPoints > 1;
+        }
+        else if ( arg == "--image" )
+        {
+            const QStringList size = value.split( 'x' );
+            ok = ( size.size() == 2 );
+            if ( ok )
+            {
+                bool okW, okH;
+                settings.imageSize = QSize( size[0].toInt( &okW ), size[1].toInt( &okH ) );
+                ok = okW && okH && !settings.imageSize.isEmpty();
+            }
+        }
+        else if ( arg == "--iterations" )
+        {
+            iterations = value.toInt( &ok );
+            ok = ok && iterations > 0;
+        }
+        else if ( arg == "--threads" )
+        {
+            settings.numThreads = value.toUInt( &ok );
+        }
+        else if ( arg == "--filter" )
+        {
+            filter = value;
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if ( !ok )
+        {
+            printUsage();
+            return 1;
+        }
+
+        i++; // value
+    }
+
+    const QList< Benchmark* > benchmarks = createBenchmarks();
+
+    QList< Result > results;
+
+    for ( int i = 0; i < benchmarks.size(); i++ )
+    {
+        Benchmark* benchmark = benchmarks[i];
+
+        if ( !filter.isEmpty() && !benchmark->name().contains( filter ) )
+            continue;
+
+        if ( listOnly )
+        {
+            printf( "%s\n", qPrintable( benchmark->name() ) );
+            continue;
+        }
+
+        const Result result = runBenchmark( benchmark, settings, iterations );
+
+        if ( format == "csv" )
+        {
+            if ( results.isEmpty() )
+                printCsvHeader();
+
+            printCsvRow( result );
+        }
+
+        results += result;
+    }
+
+    if ( format == "json" && !listOnly )
+        printJson( settings, results );
+
+    qDeleteAll( benchmarks );
+
     return 0;
 }
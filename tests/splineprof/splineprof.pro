@@ -9,10 +9,14 @@
 
 include( $${PWD}/../tests.pri )
 
-CONFIG -= gui
-
 TARGET = splineprof
 
+win32:LIBS += -lpsapi
+
+HEADERS = \
+    benchmarks.h
+
 SOURCES = \
+    benchmarks.cpp \
     main.cpp
 